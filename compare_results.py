@@ -0,0 +1,177 @@
+import argparse
+import collections
+import json
+import math
+import os
+import sys
+
+# Compares two google benchmark json outputs (or two directories of them,
+# matched by file name) and exits with 1 on a statistically significant
+# regression.
+#
+# Expected json (what the benchmarks target writes):
+#   context:    object, the merge_* keys describe the run configuration
+#   benchmarks: list of objects with
+#     name:      benchmark_merge<merger>/lhs_size/rhs_size[/distribution]
+#     real_time: number
+#     time_unit: ns | us | ms | s
+#     run_name, run_type: optional, present with --benchmark_repetitions
+#
+# With repetitions every measurement is tested separately (Mann-Whitney U).
+# Without them the measurements of one family (same name without the sizes)
+# are paired by sizes and tested together (Wilcoxon signed-rank).
+
+timeUnits = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+def normalCdf(x):
+    return 0.5 * (1.0 + math.erf(x / math.sqrt(2.0)))
+
+def ranks(xs):
+    order = sorted(range(len(xs)), key = lambda i: xs[i])
+    res = [0.0] * len(xs)
+    i = 0
+    while i < len(order):
+        j = i
+        while j + 1 < len(order) and xs[order[j + 1]] == xs[order[i]]:
+            j += 1
+        for k in range(i, j + 1):
+            res[order[k]] = (i + j) / 2.0 + 1.0
+        i = j + 1
+    return res
+
+# One sided: probability to see new this much slower than old by chance.
+def mannWhitneyU(old, new):
+    n1 = len(old)
+    n2 = len(new)
+    rankSum = sum(ranks(old + new)[n1:])
+    u = rankSum - n2 * (n2 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    sigma = math.sqrt(n1 * n2 * (n1 + n2 + 1) / 12.0)
+    if sigma == 0:
+        return 1.0
+    return 1.0 - normalCdf((u - 0.5 - mean) / sigma)
+
+# One sided: probability to see these positive differences by chance.
+def wilcoxonSignedRank(diffs):
+    diffs = [d for d in diffs if d != 0]
+    n = len(diffs)
+    if n == 0:
+        return 1.0
+    absRanks = ranks([abs(d) for d in diffs])
+    w = sum(r for r, d in zip(absRanks, diffs) if d > 0)
+    mean = n * (n + 1) / 4.0
+    sigma = math.sqrt(n * (n + 1) * (2 * n + 1) / 24.0)
+    return 1.0 - normalCdf((w - 0.5 - mean) / sigma)
+
+def geometricMean(xs):
+    return math.exp(sum(math.log(x) for x in xs) / len(xs))
+
+def familyName(name):
+    parts = name.split('/')
+    return '/'.join(p for p in parts if not p.isdigit())
+
+class results:
+    def __init__(self, path):
+        loaded = json.load(open(path))
+        if 'benchmarks' not in loaded:
+            raise ValueError(path + ': no "benchmarks" list')
+
+        self.context = loaded.get('context', {})
+        self.samples = collections.OrderedDict()
+        for measurement in loaded['benchmarks']:
+            if measurement.get('run_type', 'iteration') != 'iteration':
+                continue
+            if measurement.get('error_occurred', False):
+                continue
+            for key in ['name', 'real_time', 'time_unit']:
+                if key not in measurement:
+                    raise ValueError(path + ': measurement without "' + key + '"')
+            name = measurement.get('run_name', measurement['name'])
+            time = float(measurement['real_time']) * timeUnits[measurement['time_unit']]
+            self.samples.setdefault(name, []).append(time)
+
+class comparison:
+    def __init__(self, label, ratio, pValue, regression):
+        self.label = label
+        self.ratio = ratio
+        self.pValue = pValue
+        self.regression = regression
+
+class runner:
+    def __init__(self):
+        self.pairs = []
+        self.threshold = None
+        self.alpha = None
+        self.comparisons = []
+
+    def parseFromOptions(self):
+        parser = argparse.ArgumentParser(\
+        description="Compares two sets of google benchmark's json results")
+        parser.add_argument('old', help='baseline json or directory of jsons')
+        parser.add_argument('new', help='json or directory of jsons to check')
+        parser.add_argument('--threshold', type=float, dest='threshold', default=0.05,
+                            help='relative slowdown that is considered a regression')
+        parser.add_argument('--alpha', type=float, dest='alpha', default=0.01,
+                            help='significance level')
+        options = parser.parse_args()
+        self.threshold = options.threshold
+        self.alpha = options.alpha
+
+        if os.path.isdir(options.old) != os.path.isdir(options.new):
+            parser.error('both old and new should be files or directories')
+
+        if not os.path.isdir(options.old):
+            self.pairs.append((options.old, options.new))
+            return
+
+        for fileName in sorted(os.listdir(options.old)):
+            newPath = os.path.join(options.new, fileName)
+            if fileName.endswith('.json') and os.path.exists(newPath):
+                self.pairs.append((os.path.join(options.old, fileName), newPath))
+
+    def compareRepeated(self, label, names, old, new):
+        for name in names:
+            ratio = geometricMean(new.samples[name]) / geometricMean(old.samples[name])
+            pValue = mannWhitneyU(old.samples[name], new.samples[name])
+            regression = ratio > 1.0 + self.threshold and pValue < self.alpha
+            self.comparisons.append(comparison(label + name, ratio, pValue, regression))
+
+    def comparePaired(self, label, names, old, new):
+        logRatios = [math.log(new.samples[name][0] / old.samples[name][0])
+                     for name in names]
+        ratio = math.exp(sum(logRatios) / len(logRatios))
+        pValue = wilcoxonSignedRank([r - math.log(1.0 + self.threshold)
+                                     for r in logRatios])
+        regression = ratio > 1.0 + self.threshold and pValue < self.alpha
+        self.comparisons.append(comparison(label, ratio, pValue, regression))
+
+    def compare(self):
+        for oldPath, newPath in self.pairs:
+            old = results(oldPath)
+            new = results(newPath)
+            filePrefix = os.path.basename(oldPath) + ' ' if len(self.pairs) > 1 else ''
+
+            families = collections.OrderedDict()
+            for name in old.samples:
+                if name in new.samples:
+                    families.setdefault(familyName(name), []).append(name)
+
+            for family, names in families.items():
+                repeated = all(len(old.samples[name]) > 1 and
+                               len(new.samples[name]) > 1 for name in names)
+                if repeated:
+                    self.compareRepeated(filePrefix, names, old, new)
+                else:
+                    self.comparePaired(filePrefix + family, names, old, new)
+
+    def report(self):
+        for c in self.comparisons:
+            print('{:<70} {:>8.3f} p={:<8.4f} {}'.format(
+                c.label, c.ratio, c.pValue, 'REGRESSION' if c.regression else ''))
+        return any(c.regression for c in self.comparisons)
+
+if __name__ == "__main__":
+    r = runner()
+    r.parseFromOptions()
+    r.compare()
+    sys.exit(1 if r.report() else 0)
@@ -0,0 +1,59 @@
+// Build time benchmark: merges big lookup tables during constant evaluation,
+// so the interesting number is how long it takes to compile this file.
+//
+//   time cmake --build . --target constexpr_benchmark_merge_biased
+//   time cmake --build . --target constexpr_benchmark_merge_linear
+//
+// The table size can be changed with -DSRT_CONSTEXPR_TABLE_SIZE=n.
+
+#include "result.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#ifndef SRT_CONSTEXPR_TABLE_SIZE
+#define SRT_CONSTEXPR_TABLE_SIZE 100000
+#endif
+
+#ifndef SRT_CONSTEXPR_MERGER
+#define SRT_CONSTEXPR_MERGER srt::merge_biased
+#endif
+
+namespace {
+
+constexpr std::size_t kLhsSize = SRT_CONSTEXPR_TABLE_SIZE;
+constexpr std::size_t kRhsSize = kLhsSize / 100;
+
+template <std::size_t N>
+constexpr std::array<std::int64_t, N> sorted_table(std::int64_t first,
+                                                   std::int64_t step) {
+  std::array<std::int64_t, N> res{};
+  for (std::size_t i = 0; i != N; ++i) {
+    res[i] = first + static_cast<std::int64_t>(i) * step;
+  }
+  return res;
+}
+
+constexpr std::array<std::int64_t, kLhsSize + kRhsSize> merged_table() {
+  auto lhs = sorted_table<kLhsSize>(0, 2);
+  auto rhs = sorted_table<kRhsSize>(1, 200);
+
+  std::array<std::int64_t, kLhsSize + kRhsSize> res{};
+  SRT_CONSTEXPR_MERGER(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                       res.begin());
+  return res;
+}
+
+constexpr auto kTable = merged_table();
+
+static_assert(kTable.front() == 0, "");
+static_assert(kTable[1] == 1, "");
+static_assert(kTable.back() == static_cast<std::int64_t>(kLhsSize - 1) * 2, "");
+
+}  // namespace
+
+int main() {
+  std::printf("%zu elements, last: %lld\n", kTable.size(),
+              static_cast<long long>(kTable.back()));
+}
@@ -1,59 +1,381 @@
+// Differential fuzzer: every merge variant against std::merge.
+//
+// libFuzzer target (clang only):
+//   ./fuzzer -max_total_time=600 ../fuzz_corpus
+// new interesting inputs are added to fuzz_corpus, so it can be committed.
+//
+// Built with SRT_FUZZER_THROUGHPUT (fuzzer_throughput target) there is no
+// checking: the variants are timed on the corpus instead.
+//   ./fuzzer_throughput ../fuzz_corpus
+
 #include "result.h"
+#include "merge_biased_view.h"
+#include "other_algorithms.h"
+#include "parallel_merge.h"
 
 #include <algorithm>
-#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <forward_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(SRT_FUZZER_THROUGHPUT)
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#endif
+
 namespace {
 
-struct stability_less {
-  bool operator()(int x, int y) const { return x < y; }
+// Input layout:
+//   byte 0    - share of the first range: size * byte / 255 elements.
+//   byte 1    - 0: values as they are, n: values % n (duplicate heavy).
+//   the rest  - values, 4 bytes each.
+struct fuzz_input {
+  std::vector<int> lhs;
+  std::vector<int> rhs;
+};
 
-  template <typename T, typename U>
-  bool operator()(const std::pair<T, U>& x, const std::pair<T, U>& y) const {
-    return x.first < y.first;
+bool decode(const std::uint8_t* data, std::size_t size, fuzz_input* res) {
+  if (size < 2) return false;
+  const std::size_t lhs_share = data[0];
+  const std::uint32_t modulo = data[1];
+  data += 2;
+  size -= 2;
+
+  std::vector<int> values(size / sizeof(int));
+  for (int& value : values) {
+    std::uint32_t bytes;
+    std::memcpy(&bytes, data, sizeof(bytes));
+    data += sizeof(bytes);
+    value = modulo ? static_cast<int>(bytes % modulo)
+                   : static_cast<int>(bytes);
   }
+
+  const auto lhs_size =
+      static_cast<std::ptrdiff_t>(values.size() * lhs_share / 255);
+  res->lhs.assign(values.begin(), values.begin() + lhs_size);
+  res->rhs.assign(values.begin() + lhs_size, values.end());
+  std::sort(res->lhs.begin(), res->lhs.end());
+  std::sort(res->rhs.begin(), res->rhs.end());
+  return true;
+}
+
+// origin is the position in lhs followed by rhs: equal keys have to come out
+// in the std::merge order, so a lost or reordered element is always visible.
+struct element {
+  int key;
+  int origin;
 };
 
-using test_t = std::pair<int, bool>;
+// Moved from elements have no key: any variant that looks at an element
+// after moving it crashes.
+struct move_only {
+  std::unique_ptr<int> key;
+  int origin = 0;
 
-}  // namespace
+  move_only() = default;
+  move_only(int key, int origin)
+      : key{std::make_unique<int>(key)}, origin{origin} {}
+};
+
+struct key_less {
+  bool operator()(const element& x, const element& y) const {
+    return x.key < y.key;
+  }
 
-extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data_bytes, size_t size_bytes) {
-  const int* data = reinterpret_cast<const int*>(data_bytes);
-  size_t size = size_bytes / sizeof(int);
+  bool operator()(const move_only& x, const move_only& y) const {
+    return *x.key < *y.key;
+  }
+};
+
+// What a variant needs from the input, the checks skip what it can't do.
+enum merger_requirements {
+  kForwardIterators = 0,
+  kRandomAccess = 1 << 0,
+  kCopyable = 1 << 1,
+};
+
+template <int Requirements>
+using requires_t = std::integral_constant<int, Requirements>;
 
-  if (size < 1)
-    return 0;
+// visitor(name, requires_t<...>, merger): merger(f1, l1, f2, l2, o, p) -> o.
+// New variants go here.
+template <typename Visitor>
+void for_each_merger(Visitor visitor) {
+  visitor("upper_bound_based", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::upper_bound_based::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("libstd", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::libstd::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v1", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v1::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v2", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v2::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v3", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v3::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v4", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v4::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v5", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v5::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v6", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v6::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v7", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v7::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v8", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v8::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("v9", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::v9::merge(f1, l1, f2, l2, o, p);
+          });
+  visitor("merge_linear", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::merge_linear(f1, l1, f2, l2, o, p);
+          });
+  visitor("merge_biased", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::merge_biased(f1, l1, f2, l2, o, p);
+          });
+  visitor("merge_biased<0,3>", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::merge_biased<0, 3>(f1, l1, f2, l2, o, p);
+          });
+  visitor("merge_biased<6,7>", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::merge_biased<6, 7>(f1, l1, f2, l2, o, p);
+          });
+  visitor("merge_biased_adaptive", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            return srt::merge_biased_adaptive(f1, l1, f2, l2, o, p);
+          });
+  visitor("merge_biased_view", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            auto view = srt::make_merge_biased_view(f1, l1, f2, l2, p);
+            return std::copy(view.begin(), view.end(), o);
+          });
+  visitor("merge_biased_view_runs", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            auto view = srt::make_merge_biased_view(f1, l1, f2, l2, p);
+            for (auto run = view.next_run(); !run.empty();
+                 run = view.next_run()) {
+              o = std::copy(run.f2, run.l2, std::copy(run.f1, run.l1, o));
+            }
+            return o;
+          });
+  visitor("merge_biased_into", requires_t<kForwardIterators>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            using T = typename std::iterator_traits<decltype(f1)>::value_type;
+            std::vector<T> c;
+            srt::merge_biased_into(f1, l1, f2, l2, c, p);
+            return std::move(c.begin(), c.end(), o);
+          });
+  // Second range split into three batches in order: ties keep their order.
+  visitor("merge_biased_batched", requires_t<kCopyable>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            using T = typename std::iterator_traits<decltype(f2)>::value_type;
+            const std::vector<T> rhs(f2, l2);
+            std::vector<std::vector<T>> batches;
+            for (std::size_t i = 0; i != 3; ++i) {
+              batches.emplace_back(rhs.begin() + rhs.size() * i / 3,
+                                   rhs.begin() + rhs.size() * (i + 1) / 3);
+            }
+            return srt::merge_biased_batched(f1, l1, batches.begin(),
+                                             batches.end(), o, p);
+          });
+  visitor("parallel_merge_biased", requires_t<kRandomAccess>{},
+          [](auto f1, auto l1, auto f2, auto l2, auto o, auto p) {
+            srt::parallel_merge_options options;
+            options.threads = 3;
+            options.pin_to_nodes = false;
+            return srt::parallel_merge_biased(f1, l1, f2, l2, o, p, options);
+          });
+}
 
-  const int distance_f_m = (*data) % size;
+std::vector<element> to_elements(const std::vector<int>& keys, int origin) {
+  std::vector<element> res;
+  res.reserve(keys.size());
+  for (int key : keys) res.push_back(element{key, origin++});
+  return res;
+}
 
-  ++data;
-  --size;
+#if !defined(SRT_FUZZER_THROUGHPUT)
 
-  const int* data_f = data;
-  const int* data_m = data_f + distance_f_m;
-  const int* data_l = data_f + size;
+bool operator==(const element& x, const element& y) {
+  return x.key == y.key && x.origin == y.origin;
+}
 
-  std::vector<test_t> lhs(distance_f_m);
-  std::transform(data_f, data_m, lhs.begin(), [](int x) { return test_t{x, false}; });
-  std::sort(lhs.begin(), lhs.end());
+bool operator==(const move_only& x, const element& y) {
+  return x.key && *x.key == y.key && x.origin == y.origin;
+}
 
-  std::vector<test_t> rhs(data_l - data_m);
-  std::transform(data_m, data_l, rhs.begin(), [](int x) { return test_t{x, true}; });
-  std::sort(rhs.begin(), rhs.end());
+[[noreturn]] void fail(const char* merger, const char* test,
+                       const fuzz_input& input) {
+  std::fprintf(stderr, "%s on %s: wrong result, lhs: %zu rhs: %zu\n", merger,
+               test, input.lhs.size(), input.rhs.size());
+  std::abort();
+}
 
-  std::vector<test_t> expected(size);
-  std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), expected.begin(), stability_less{});
+template <typename C, typename Merger>
+void check_merger(const char* name, const char* test, Merger merger,
+                  C lhs, C rhs, const fuzz_input& input,
+                  const std::vector<element>& expected) {
+  using T = typename C::value_type;
+  std::vector<T> actual(expected.size());
+  auto actual_l = merger(std::make_move_iterator(lhs.begin()),
+                         std::make_move_iterator(lhs.end()),
+                         std::make_move_iterator(rhs.begin()),
+                         std::make_move_iterator(rhs.end()), actual.begin(),
+                         key_less{});
+  if (actual_l != actual.end() ||
+      !std::equal(actual.begin(), actual.end(), expected.begin())) {
+    fail(name, test, input);
+  }
+}
+
+template <typename T>
+std::vector<T> make_vector(const std::vector<element>& elements) {
+  std::vector<T> res;
+  res.reserve(elements.size());
+  for (const element& x : elements) res.emplace_back(x.key, x.origin);
+  return res;
+}
+
+std::forward_list<element> make_forward_list(
+    const std::vector<element>& elements) {
+  return {elements.begin(), elements.end()};
+}
 
-  std::vector<test_t> actual_linear(size);
-  srt::merge_linear(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), actual_linear.begin(), stability_less{});
+#endif  // !defined(SRT_FUZZER_THROUGHPUT)
+
+}  // namespace
 
-  std::vector<test_t> actual_biased(size);
-  srt::merge_biased(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), actual_biased.begin(), stability_less{});
+#if !defined(SRT_FUZZER_THROUGHPUT)
 
-  assert(std::equal(expected.begin(), expected.end(), actual_linear.begin()));
-  assert(std::equal(expected.begin(), expected.end(), actual_biased.begin()));
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size) {
+  fuzz_input input;
+  if (!decode(data, size, &input)) return 0;
+
+  const std::vector<element> lhs = to_elements(input.lhs, 0);
+  const std::vector<element> rhs =
+      to_elements(input.rhs, static_cast<int>(lhs.size()));
+
+  std::vector<element> expected(lhs.size() + rhs.size());
+  std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), expected.begin(),
+             key_less{});
+
+  for_each_merger([&](const char* name, auto requirements, auto merger) {
+    constexpr int kRequirements = decltype(requirements)::value;
+
+    check_merger(name, "vector", merger, lhs, rhs, input, expected);
+
+    if constexpr (!(kRequirements & kRandomAccess)) {
+      check_merger(name, "forward_list", merger,
+                   make_forward_list(lhs), make_forward_list(rhs), input,
+                   expected);
+    }
+
+    if constexpr (!(kRequirements & kCopyable)) {
+      check_merger(name, "move_only", merger,
+                   make_vector<move_only>(lhs), make_vector<move_only>(rhs),
+                   input, expected);
+    }
+  });
 
   return 0;  // Non-zero return values are reserved for future use.
-}
\ No newline at end of file
+}
+
+#else  // defined(SRT_FUZZER_THROUGHPUT)
+
+int main(int argc, char** argv) {
+  namespace fs = std::filesystem;
+
+  std::vector<fs::path> files;
+  for (int i = 1; i < argc; ++i) {
+    if (fs::is_directory(argv[i])) {
+      for (const auto& entry : fs::directory_iterator(argv[i])) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+      }
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<std::pair<std::vector<element>, std::vector<element>>> corpus;
+  std::size_t total_size = 0;
+  for (const fs::path& file : files) {
+    std::ifstream in(file, std::ios::binary);
+    const std::vector<char> bytes{std::istreambuf_iterator<char>(in),
+                                  std::istreambuf_iterator<char>()};
+    fuzz_input input;
+    if (!decode(reinterpret_cast<const std::uint8_t*>(bytes.data()),
+                bytes.size(), &input)) {
+      continue;
+    }
+    corpus.emplace_back(to_elements(input.lhs, 0),
+                        to_elements(input.rhs, static_cast<int>(input.lhs.size())));
+    total_size += input.lhs.size() + input.rhs.size();
+  }
+
+  if (!total_size) {
+    std::fprintf(stderr, "usage: %s corpus_dir_or_file...\n", argv[0]);
+    return 1;
+  }
+
+  // Every variant merges the whole corpus until at least kMinTime passes.
+  constexpr auto kMinTime = std::chrono::milliseconds(200);
+
+  std::printf("%zu inputs, %zu elements\n", corpus.size(), total_size);
+  std::printf("%-24s %12s\n", "merger", "ns/element");
+
+  std::vector<element> out;
+  for_each_merger([&](const char* name, auto, auto merger) {
+    std::size_t rounds = 0;
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration{};
+    do {
+      for (const auto& [lhs, rhs] : corpus) {
+        out.resize(lhs.size() + rhs.size());
+        merger(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out.begin(),
+               key_less{});
+      }
+      ++rounds;
+      elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < kMinTime);
+
+    const double ns =
+        std::chrono::duration<double, std::nano>(elapsed).count();
+    std::printf("%-24s %12.3f\n", name,
+                ns / static_cast<double>(rounds * total_size));
+  });
+  return 0;
+}
+
+#endif  // defined(SRT_FUZZER_THROUGHPUT)
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "result.h"
+
+namespace srt {
+
+// Counting and existence checks for a big [f1, l1) against a small [f2, l2),
+// without an output: every element of the second range gallops over the
+// first one, like merge_biased does.
+
+namespace detail {
+
+// The first element in [f, l) that doesn't satisfy p. find_boundary needs
+// an element that stops the search, so it is repeated until it returns one.
+template <typename I, typename P>
+I partition_point_biased_checked(I f, I l, P p, std::forward_iterator_tag) {
+  while (f != l) {
+    f = find_boundary(f, l, p);
+    if (!p(*f)) return f;
+    ++f;
+  }
+  return f;
+}
+
+// With random access the middle of [f, l) is far away from the answer when
+// the second range is dense: a cache miss per element. So first an element
+// that stops the search is looked for with end checks, at f, f + 2, f + 6,
+// f + 14, ... (2^k - 2: f moves past every element that satisfies p), and
+// find_boundary only searches up to it.
+template <typename I, typename P>
+I partition_point_biased_checked(I f, I l, P p,
+                                 std::random_access_iterator_tag) {
+  I bound = l;
+  for (DifferenceType<I> step = 1; step < l - f; step += step) {
+    I test = f + (step - 1);
+    if (!p(*test)) {
+      bound = test + 1;
+      break;
+    }
+    f = test + 1;
+  }
+  return partition_point_biased_checked(f, bound, p,
+                                        std::forward_iterator_tag{});
+}
+
+template <typename I, typename P>
+// requiers ForwardIterator<I> && UnaryPredicate<P, ValueType<I>>
+I partition_point_biased_checked(I f, I l, P p) {
+  return partition_point_biased_checked(
+      f, l, p, typename std::iterator_traits<I>::iterator_category{});
+}
+
+template <typename I1, typename I2, typename P>
+// requiers ForwardIterator<I1> && InputIterator<I2> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+DifferenceType<I2> count_common_biased_scalar(I1 f1, I1 l1, I2 f2, I2 l2,
+                                              P p) {
+  DifferenceType<I2> res = 0;
+  for (; f2 != l2; ++f2) {
+    f1 = partition_point_biased_checked(
+        f1, l1, [&](const auto& x) { return p(x, *f2); });
+    if (f1 == l1) break;
+    if (p(*f2, *f1)) continue;
+    ++res;
+    ++f1;
+  }
+  return res;
+}
+
+template <typename I1, typename I2, typename P>
+// requiers ForwardIterator<I1> && InputIterator<I2> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+bool includes_biased_scalar(I1 f1, I1 l1, I2 f2, I2 l2, P p) {
+  for (; f2 != l2; ++f2) {
+    f1 = partition_point_biased_checked(
+        f1, l1, [&](const auto& x) { return p(x, *f2); });
+    if (f1 == l1 || p(*f2, *f1)) return false;
+    ++f1;
+  }
+  return true;
+}
+
+// Ranges the vectorized version can take as pointers.
+template <typename I>
+struct is_int64_contiguous
+    : std::integral_constant<
+          bool,
+          std::is_same<I, std::int64_t*>::value ||
+              std::is_same<I, const std::int64_t*>::value ||
+              std::is_same<I, std::vector<std::int64_t>::iterator>::value ||
+              std::is_same<I,
+                           std::vector<std::int64_t>::const_iterator>::value> {
+};
+
+#if defined(__AVX2__)
+
+// Lower bound of x in [f, l): the first 8 elements are checked with two
+// vector compares instead of the linear probes, the rest is galloped over.
+inline const std::int64_t* lower_bound_biased_avx2(const std::int64_t* f,
+                                                    const std::int64_t* l,
+                                                    std::int64_t x) {
+  const __m256i xs = _mm256_set1_epi64x(x);
+  for (int i = 0; i != 2 && l - f >= 4; ++i) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f));
+    // Sorted: the lanes less than x are a prefix.
+    const int less =
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(xs, v)));
+    if (less != 0xf) return f + __builtin_popcount(static_cast<unsigned>(less));
+    f += 4;
+  }
+  return partition_point_biased_checked(
+      f, l, [x](std::int64_t y) { return y < x; });
+}
+
+inline std::ptrdiff_t count_common_biased_avx2(const std::int64_t* f1,
+                                               const std::int64_t* l1,
+                                               const std::int64_t* f2,
+                                               const std::int64_t* l2) {
+  std::ptrdiff_t res = 0;
+  for (; f2 != l2; ++f2) {
+    f1 = lower_bound_biased_avx2(f1, l1, *f2);
+    if (f1 == l1) break;
+    if (*f2 < *f1) continue;
+    ++res;
+    ++f1;
+  }
+  return res;
+}
+
+inline bool includes_biased_avx2(const std::int64_t* f1,
+                                 const std::int64_t* l1,
+                                 const std::int64_t* f2,
+                                 const std::int64_t* l2) {
+  for (; f2 != l2; ++f2) {
+    f1 = lower_bound_biased_avx2(f1, l1, *f2);
+    if (f1 == l1 || *f2 < *f1) return false;
+    ++f1;
+  }
+  return true;
+}
+
+#endif  // defined(__AVX2__)
+
+}  // namespace detail
+
+// Number of elements std::set_intersection would write.
+template <typename I1, typename I2, typename P>
+// requiers ForwardIterator<I1> && InputIterator<I2> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+detail::DifferenceType<I2> count_common_biased(I1 f1, I1 l1, I2 f2, I2 l2,
+                                               P p) {
+  return detail::count_common_biased_scalar(f1, l1, f2, l2, p);
+}
+
+// For std::int64_t arrays and vectors compiled with AVX2 (-mavx2 or
+// -march=native) the linear part of the search is vectorized.
+template <typename I1, typename I2>
+detail::DifferenceType<I2> count_common_biased(I1 f1, I1 l1, I2 f2, I2 l2) {
+#if defined(__AVX2__)
+  if constexpr (detail::is_int64_contiguous<I1>::value &&
+                detail::is_int64_contiguous<I2>::value) {
+    if (f1 == l1 || f2 == l2) return 0;
+    return detail::count_common_biased_avx2(&*f1, &*f1 + (l1 - f1), &*f2,
+                                            &*f2 + (l2 - f2));
+  }
+#endif
+  return count_common_biased(f1, l1, f2, l2, detail::less{});
+}
+
+// Same as std::includes: every element of [f2, l2) has its own equal
+// element in [f1, l1).
+template <typename I1, typename I2, typename P>
+// requiers ForwardIterator<I1> && InputIterator<I2> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+bool includes_biased(I1 f1, I1 l1, I2 f2, I2 l2, P p) {
+  return detail::includes_biased_scalar(f1, l1, f2, l2, p);
+}
+
+template <typename I1, typename I2>
+bool includes_biased(I1 f1, I1 l1, I2 f2, I2 l2) {
+#if defined(__AVX2__)
+  if constexpr (detail::is_int64_contiguous<I1>::value &&
+                detail::is_int64_contiguous<I2>::value) {
+    if (f2 == l2) return true;
+    if (f1 == l1) return false;
+    return detail::includes_biased_avx2(&*f1, &*f1 + (l1 - f1), &*f2,
+                                        &*f2 + (l2 - f2));
+  }
+#endif
+  return includes_biased(f1, l1, f2, l2, detail::less{});
+}
+
+}  // namespace srt
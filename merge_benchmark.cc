@@ -2,63 +2,230 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <list>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
 #include <random>
 #include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include "../partition_point_biased_blog_post/result.h"
+#include "intersection_biased.h"
+#include "merge_biased_view.h"
+#include "merge_join_biased.h"
 #include "other_algorithms.h"
+#include "parallel_merge.h"
 #include "result.h"
 
-namespace {
+// Set by CMake, recorded in the json context.
+#if !defined(SRT_BENCHMARK_FLAGS)
+#define SRT_BENCHMARK_FLAGS "unknown"
+#endif
+#if !defined(SRT_BENCHMARK_ALIGN_FUNCTIONS)
+#define SRT_BENCHMARK_ALIGN_FUNCTIONS "default"
+#endif
+#if !defined(SRT_BENCHMARK_ALIGN_LOOPS)
+#define SRT_BENCHMARK_ALIGN_LOOPS "default"
+#endif
 
-constexpr bool kOnlyLastElements = false;
+namespace {
 
 constexpr std::size_t kProblemSize = 2000u;
-constexpr std::size_t kMaxRhsSize = kOnlyLastElements ? 40 : kProblemSize;
-constexpr std::size_t kStep = kMaxRhsSize / 40;
+constexpr std::size_t kParallelProblemSize = std::size_t{1} << 24;
 
-void set_benchmark_input_sizes(benchmark::internal::Benchmark* bench) {
-  std::size_t lhs_size = kProblemSize;
-  std::size_t rhs_size = 0;
+// Defaults reproduce the "full range" mode, pass --merge_max_rhs_size=40 for
+// the "last 40 elements" one.
+struct merge_benchmark_options {
+  std::vector<std::size_t> problem_sizes{kProblemSize};
+  std::size_t max_rhs_size = 0;  // 0 means the whole problem size.
+  std::size_t steps = 40;
+  std::vector<std::string> distributions{"uniform"};
+  std::vector<std::string> outputs{"allocate", "reuse"};
+  std::vector<std::string> algorithms;  // Empty means all of them.
+  // Empty means one thread and no /threads: suffix in the names.
+  std::vector<std::size_t> threads;
+  std::string input_placement = "thread";
+  // Total sizes for parallel_merge_biased, 1% of which is rhs.
+  // Empty: kParallelProblemSize if merge_biased is selected explicitly.
+  std::vector<std::size_t> parallel_sizes;
+};
+
+merge_benchmark_options& options() {
+  static merge_benchmark_options res;
+  return res;
+}
 
-  do {
-    bench->Args({static_cast<int>(lhs_size), static_cast<int>(rhs_size)});
-    lhs_size -= kStep;
-    rhs_size += kStep;
-  } while (rhs_size <= kMaxRhsSize);
+template <typename Enum, std::size_t N>
+bool parse_enum(const char* const (&names)[N], const std::string& name,
+                Enum* res) {
+  auto found = std::find(std::begin(names), std::end(names), name);
+  if (found == std::end(names)) return false;
+  *res = static_cast<Enum>(std::distance(std::begin(names), found));
+  return true;
 }
 
+// uniform    - both sides are random in [1, problem_size * 100].
+// duplicates - both sides are random in [1, problem_size / 10].
+// disjoint   - every rhs element is bigger than every lhs element.
+// edge_overlap - rhs starts in the last 5% of the lhs values and goes on
+//                past them: only the edges interleave.
+enum class input_distribution { uniform, duplicates, disjoint, edge_overlap };
+
+constexpr const char* kDistributionNames[] = {"uniform", "duplicates",
+                                              "disjoint", "edge_overlap"};
+
+// allocate - a new vector for every merge, page faults and zeroing included.
+// reuse    - one buffer for all merges: only the merge is timed.
+// into     - merge_biased_into one vector, cleared before every merge: no
+//            malloc, zeroing included.
+// pmr      - merge_biased_into a new std::pmr::vector for every merge from a
+//            memory resource that is reset after it: zeroing but no malloc.
+enum class output_mode { allocate, reuse, into, pmr };
+
+constexpr const char* kOutputModeNames[] = {"allocate", "reuse", "into",
+                                            "pmr"};
+
+// With several threads each of them merges its own copy of the input and
+// thread i runs on node i * node_count / threads (the main thread, which runs
+// thread 0, on node 0).
+// thread - every thread copies the input before timing, so first touch puts
+//          the copy on the thread's NUMA node. Not cached: an earlier run's
+//          threads may have been on other nodes.
+// main   - all copies are built by the main thread on node 0 before running:
+//          remote for the threads on other nodes.
+enum class input_placement { thread, main };
+
+constexpr const char* kInputPlacementNames[] = {"thread", "main"};
+
 using test_type = std::int64_t;
 using test_type_vec = std::vector<test_type>;
 using test_merge_input = std::pair<test_type_vec, test_type_vec>;
 
-test_type random_test_type_value() {
-  static std::mt19937 g;
-  static std::uniform_int_distribution<> dis(1, int(kProblemSize) * 100);
+test_type random_test_type_value(test_type min, test_type max) {
+  thread_local std::mt19937 g;
+  std::uniform_int_distribution<test_type> dis(min, max);
   return dis(g);
 }
 
-test_type_vec random_test_type_sorted_vec(std::size_t size) {
+test_type_vec random_test_type_sorted_vec(std::size_t size, test_type min,
+                                          test_type max) {
   test_type_vec res(size);
-  std::generate(res.begin(), res.end(), random_test_type_value);
+  std::generate(res.begin(), res.end(),
+                [&] { return random_test_type_value(min, max); });
   std::sort(res.begin(), res.end());
   return res;
 }
 
-const test_merge_input& input_data(std::size_t lhs_size, std::size_t rhs_size) {
+test_type_vec random_test_type_sorted_vec(std::size_t size) {
+  return random_test_type_sorted_vec(size, 1,
+                                     static_cast<test_type>(kProblemSize) * 100);
+}
+
+test_merge_input generate_input(std::size_t lhs_size, std::size_t rhs_size,
+                                input_distribution distribution) {
+  const auto problem_size = static_cast<test_type>(lhs_size + rhs_size);
+  switch (distribution) {
+    case input_distribution::uniform:
+      return {random_test_type_sorted_vec(lhs_size, 1, problem_size * 100),
+              random_test_type_sorted_vec(rhs_size, 1, problem_size * 100)};
+    case input_distribution::duplicates: {
+      const test_type max = std::max(problem_size / 10, test_type{1});
+      return {random_test_type_sorted_vec(lhs_size, 1, max),
+              random_test_type_sorted_vec(rhs_size, 1, max)};
+    }
+    case input_distribution::disjoint:
+      return {random_test_type_sorted_vec(lhs_size, 1, problem_size * 100),
+              random_test_type_sorted_vec(rhs_size, problem_size * 100 + 1,
+                                          problem_size * 200)};
+    case input_distribution::edge_overlap:
+      return {random_test_type_sorted_vec(lhs_size, 1, problem_size * 100),
+              random_test_type_sorted_vec(rhs_size, problem_size * 95 + 1,
+                                          problem_size * 195)};
+  }
+  return {};
+}
+
+// copy_index distinguishes private copies of the same input for different
+// threads.
+const test_merge_input& input_data(
+    std::size_t lhs_size, std::size_t rhs_size,
+    input_distribution distribution = input_distribution::uniform,
+    int copy_index = 0) {
   // Cache makes sence if we would want to call this function multiple times for
   // the same input. Don't think it's a fantastic idea though because having
   // multiple benchmarks might screw up code alignment.
-  static std::map<std::pair<std::size_t, std::size_t>, test_merge_input> cache;
+  static std::map<
+      std::tuple<std::size_t, std::size_t, input_distribution, int>,
+      test_merge_input>
+      cache;
+  static std::mutex cache_mutex;
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  auto key = std::make_tuple(lhs_size, rhs_size, distribution, copy_index);
+  auto in_cache = cache.find(key);
+  if (in_cache != cache.end()) return in_cache->second;
+
+  // Copies have the values of copy 0: every thread merges the same input.
+  auto original_key = std::make_tuple(lhs_size, rhs_size, distribution, 0);
+  auto original = cache.find(original_key);
+  if (original == cache.end()) {
+    original =
+        cache
+            .insert({original_key,
+                     generate_input(lhs_size, rhs_size, distribution)})
+            .first;
+  }
+  return cache.insert({key, original->second}).first->second;
+}
+
+// Benchmark thread i out of n runs on this node, the same way
+// parallel_merge_biased places its workers.
+int node_of_thread(int i, int n) {
+  return static_cast<int>(static_cast<long>(i) * srt::numa::node_count() / n);
+}
+
+using test_batches = std::vector<test_type_vec>;
+using test_batched_merge_input = std::pair<test_type_vec, test_batches>;
 
-  auto in_cache = cache.find({lhs_size, rhs_size});
+constexpr std::size_t kBatchedBaseSize = kProblemSize * 100;
+constexpr std::size_t kBatchSize = 40;
+constexpr std::size_t kMaxBatchCount = 64;
+
+void set_batched_benchmark_input_sizes(benchmark::internal::Benchmark* bench) {
+  for (std::size_t batch_count = 1; batch_count <= kMaxBatchCount;
+       batch_count *= 2) {
+    bench->Args({static_cast<int>(kBatchedBaseSize),
+                 static_cast<int>(batch_count), static_cast<int>(kBatchSize)});
+  }
+}
+
+const test_batched_merge_input& batched_input_data(std::size_t base_size,
+                                                   std::size_t batch_count,
+                                                   std::size_t batch_size) {
+  static std::map<std::tuple<std::size_t, std::size_t, std::size_t>,
+                  test_batched_merge_input>
+      cache;
+
+  auto key = std::make_tuple(base_size, batch_count, batch_size);
+  auto in_cache = cache.find(key);
   if (in_cache != cache.end()) return in_cache->second;
 
+  test_batches batches(batch_count);
+  std::generate(batches.begin(), batches.end(),
+                [&] { return random_test_type_sorted_vec(batch_size); });
+
   return cache
-      .insert({{lhs_size, rhs_size},
-               {random_test_type_sorted_vec(lhs_size),
-                random_test_type_sorted_vec(rhs_size)}})
+      .insert({key, {random_test_type_sorted_vec(base_size), std::move(batches)}})
       .first->second;
 }
 
@@ -146,6 +313,27 @@ struct merge_v9 {
   }
 };
 
+struct merge_linear {
+  template <typename I1, typename I2, typename O>
+  O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+    return srt::merge_linear(f1, l1, f2, l2, o);
+  }
+};
+
+struct merge_biased {
+  template <typename I1, typename I2, typename O>
+  O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+    return srt::merge_biased(f1, l1, f2, l2, o);
+  }
+};
+
+struct merge_biased_adaptive {
+  template <typename I1, typename I2, typename O>
+  O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+    return srt::merge_biased_adaptive(f1, l1, f2, l2, o);
+  }
+};
+
 struct std_copy {
   template <typename I1, typename I2, typename O>
   O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
@@ -154,19 +342,938 @@ struct std_copy {
   }
 };
 
+struct merge_biased_batched {
+  template <typename I1, typename I2, typename O>
+  O operator()(I1 f1, I1 l1, I2 batches_f, I2 batches_l, O o) {
+    return srt::merge_biased_batched(f1, l1, batches_f, batches_l, o);
+  }
+};
+
+struct sequential_merge_biased {
+  template <typename I1, typename I2, typename O>
+  O operator()(I1 f1, I1 l1, I2 batches_f, I2 batches_l, O o) {
+    if (batches_f == batches_l) return std::copy(f1, l1, o);
+
+    // Every merge but the last one goes into a temporary, like it would
+    // when the base is updated in place batch by batch.
+    I2 last = std::prev(batches_l);
+    if (batches_f == last) {
+      return srt::merge_biased(f1, l1, last->begin(), last->end(), o);
+    }
+
+    test_type_vec acc(static_cast<std::size_t>(std::distance(f1, l1)) +
+                      batches_f->size());
+    srt::merge_biased(f1, l1, batches_f->begin(), batches_f->end(),
+                      acc.begin());
+    test_type_vec buf;
+    for (++batches_f; batches_f != last; ++batches_f) {
+      buf.resize(acc.size() + batches_f->size());
+      srt::merge_biased(acc.begin(), acc.end(), batches_f->begin(),
+                        batches_f->end(), buf.begin());
+      acc.swap(buf);
+    }
+    return srt::merge_biased(acc.begin(), acc.end(), last->begin(),
+                             last->end(), o);
+  }
+};
+
+// Sums the first k merged elements: stands for a top-k/pagination consumer.
+struct first_k_full_merge {
+  template <typename I1, typename I2>
+  test_type operator()(I1 f1, I1 l1, I2 f2, I2 l2, std::size_t k) {
+    test_type_vec res(static_cast<std::size_t>(std::distance(f1, l1) +
+                                               std::distance(f2, l2)));
+    srt::merge_biased(f1, l1, f2, l2, res.begin());
+    return std::accumulate(res.begin(), res.begin() + k, test_type{0});
+  }
+};
+
+struct first_k_view {
+  template <typename I1, typename I2>
+  test_type operator()(I1 f1, I1 l1, I2 f2, I2 l2, std::size_t k) {
+    auto view = srt::make_merge_biased_view(f1, l1, f2, l2);
+    test_type sum = 0;
+    for (auto it = view.begin(); k; --k, ++it) sum += *it;
+    return sum;
+  }
+};
+
+struct first_k_view_runs {
+  template <typename I1, typename I2>
+  test_type operator()(I1 f1, I1 l1, I2 f2, I2 l2, std::size_t k) {
+    auto view = srt::make_merge_biased_view(f1, l1, f2, l2);
+    test_type sum = 0;
+    auto take = [&](auto f, auto l) {
+      auto n = std::min(k, static_cast<std::size_t>(std::distance(f, l)));
+      sum = std::accumulate(f, std::next(f, n), sum);
+      k -= n;
+    };
+    while (k) {
+      auto run = view.next_run();
+      take(run.f1, run.l1);
+      take(run.f2, run.l2);
+    }
+    return sum;
+  }
+};
+
+// Merge two std::lists in place, relinking the nodes.
+struct list_merge {
+  void operator()(std::list<test_type>& lhs, std::list<test_type>& rhs) {
+    lhs.merge(rhs);
+  }
+};
+
+struct list_merge_biased {
+  void operator()(std::list<test_type>& lhs, std::list<test_type>& rhs) {
+    srt::merge_biased(lhs, rhs);
+  }
+};
+
+// What merge_biased_into does, for any merger: test_type is trivial, so the
+// output is resized.
+template <typename Merger, typename C>
+void merge_into(const test_merge_input& input, C& c) {
+  if constexpr (std::is_same<Merger, merge_biased>::value) {
+    srt::merge_biased_into(input.first.begin(), input.first.end(),
+                           input.second.begin(), input.second.end(), c);
+  } else {
+    const std::size_t old_size = c.size();
+    c.resize(old_size + input.first.size() + input.second.size());
+    Merger{}(input.first.begin(), input.first.end(), input.second.begin(),
+             input.second.end(), c.begin() + old_size);
+  }
+}
+
 }  // namespace
 
 template <typename Merger>
-void benchmark_merge(benchmark::State& state) {
+void benchmark_merge(benchmark::State& state, std::size_t lhs_size,
+                     std::size_t rhs_size, input_distribution distribution,
+                     output_mode output) {
+  const merge_benchmark_options& opts = options();
+  input_placement placement = input_placement::thread;
+  parse_enum(kInputPlacementNames, opts.input_placement, &placement);
+
+  const test_merge_input* cached_input =
+      &input_data(lhs_size, rhs_size, distribution, 0);
+  test_merge_input local_input;
+  if (!opts.threads.empty()) {
+    srt::numa::run_on_node(node_of_thread(state.thread_index(),
+                                          state.threads()));
+    if (placement == input_placement::main) {
+      cached_input = &input_data(lhs_size, rhs_size, distribution,
+                                 state.thread_index());
+    } else {
+      // Same values as every other run: a copy of the cached input.
+      local_input = *cached_input;
+      cached_input = &local_input;
+    }
+  }
+  const test_merge_input& input = *cached_input;
+  auto merge = [&](auto o) {
+    Merger{}(input.first.begin(), input.first.end(), input.second.begin(),
+             input.second.end(), o);
+  };
+
+  switch (output) {
+    case output_mode::allocate: {
+      for (auto _ : state) {
+        test_type_vec res(lhs_size + rhs_size);
+        merge(res.begin());
+      }
+      break;
+    }
+    case output_mode::reuse: {
+      test_type_vec res(lhs_size + rhs_size);
+      for (auto _ : state) {
+        merge(res.begin());
+        benchmark::ClobberMemory();
+      }
+      break;
+    }
+    case output_mode::into: {
+      test_type_vec res;
+      res.reserve(lhs_size + rhs_size);
+      for (auto _ : state) {
+        res.clear();
+        merge_into<Merger>(input, res);
+        benchmark::ClobberMemory();
+      }
+      break;
+    }
+    case output_mode::pmr: {
+      test_type_vec buffer(lhs_size + rhs_size);
+      std::pmr::monotonic_buffer_resource resource(
+          buffer.data(), buffer.size() * sizeof(test_type),
+          std::pmr::null_memory_resource());
+      for (auto _ : state) {
+        {
+          std::pmr::vector<test_type> res(&resource);
+          merge_into<Merger>(input, res);
+          benchmark::ClobberMemory();
+        }
+        resource.release();
+      }
+      break;
+    }
+  }
+
+  // Both inputs are read and the output is written once: summed over
+  // threads this is the memory traffic we ask for.
+  state.SetBytesProcessed(static_cast<std::int64_t>(
+      state.iterations() * 2 * (lhs_size + rhs_size) * sizeof(test_type)));
+}
+
+// Names are benchmark_merge<merger>/lhs_size/rhs_size, like the ones
+// BENCHMARK_TEMPLATE would give, so that draw_results.py and
+// compare_results.py work with the old results. Distributions other than
+// uniform and outputs other than allocate are appended at the end.
+template <typename Merger>
+void register_merge_benchmark(const std::string& merger_name,
+                              const std::string& distribution_str,
+                              const std::string& output_str) {
+  const merge_benchmark_options& opts = options();
+
+  input_distribution distribution = input_distribution::uniform;
+  parse_enum(kDistributionNames, distribution_str, &distribution);
+  output_mode output = output_mode::allocate;
+  parse_enum(kOutputModeNames, output_str, &output);
+  input_placement placement = input_placement::thread;
+  parse_enum(kInputPlacementNames, opts.input_placement, &placement);
+
+  for (std::size_t problem_size : opts.problem_sizes) {
+    const std::size_t max_rhs_size =
+        opts.max_rhs_size ? std::min(opts.max_rhs_size, problem_size)
+                          : problem_size;
+    const std::size_t step =
+        std::max(max_rhs_size / opts.steps, std::size_t{1});
+
+    for (std::size_t rhs_size = 0; rhs_size <= max_rhs_size;
+         rhs_size += step) {
+      const std::size_t lhs_size = problem_size - rhs_size;
+      std::string name = "benchmark_merge<" + merger_name + ">/" +
+                         std::to_string(lhs_size) + "/" +
+                         std::to_string(rhs_size);
+      if (distribution != input_distribution::uniform) {
+        name += "/" + distribution_str;
+      }
+      if (output != output_mode::allocate) name += "/" + output_str;
+      auto* bench =
+          benchmark::RegisterBenchmark(name.c_str(), benchmark_merge<Merger>,
+                                       lhs_size, rhs_size, distribution, output);
+      if (opts.threads.empty()) continue;
+
+      bench->UseRealTime();
+      for (std::size_t threads : opts.threads) {
+        bench->Threads(static_cast<int>(threads));
+        if (placement != input_placement::main) continue;
+        srt::numa::run_on_node(0);
+        for (std::size_t i = 0; i != threads; ++i) {
+          input_data(lhs_size, rhs_size, distribution, static_cast<int>(i));
+        }
+      }
+    }
+  }
+}
+
+template <typename Merger>
+void register_merge_benchmark(const std::string& merger_name) {
+  const merge_benchmark_options& opts = options();
+  if (!opts.algorithms.empty() &&
+      std::find(opts.algorithms.begin(), opts.algorithms.end(),
+                merger_name) == opts.algorithms.end()) {
+    return;
+  }
+
+  for (const std::string& output_str : opts.outputs) {
+    for (const std::string& distribution_str : opts.distributions) {
+      register_merge_benchmark<Merger>(merger_name, distribution_str,
+                                       output_str);
+    }
+  }
+}
+
+// visitor(name, merger) for every merger of benchmark_merge.
+template <typename Visitor>
+void for_each_merger(Visitor visitor) {
+  visitor("upper_bound_based_merge", upper_bound_based_merge{});
+  visitor("std_merge", std_merge{});
+  visitor("libstd_merge", libstd_merge{});
+  visitor("merge_v1", merge_v1{});
+  visitor("merge_v2", merge_v2{});
+  visitor("merge_v3", merge_v3{});
+  visitor("merge_v4", merge_v4{});
+  visitor("merge_v5", merge_v5{});
+  visitor("merge_v6", merge_v6{});
+  visitor("merge_v7", merge_v7{});
+  visitor("merge_v8", merge_v8{});
+  visitor("merge_v9", merge_v9{});
+  visitor("merge_linear", merge_linear{});
+  visitor("merge_biased", merge_biased{});
+  visitor("merge_biased_adaptive", merge_biased_adaptive{});
+  visitor("std_copy", std_copy{});
+}
+
+void register_merge_benchmarks() {
+  for_each_merger([](const char* name, auto merger) {
+    register_merge_benchmark<decltype(merger)>(name);
+  });
+}
+
+// Big inputs for parallel merges: sorted without sorting, and allocated
+// without being touched so that interleaving can place the pages.
+struct big_sorted_array {
+  std::unique_ptr<test_type[]> data;
+  std::size_t size = 0;
+
+  const test_type* begin() const { return data.get(); }
+  const test_type* end() const { return data.get() + size; }
+};
+
+big_sorted_array big_sorted_array_data(std::size_t size, test_type max_gap,
+                                       bool interleave) {
+  big_sorted_array res{std::unique_ptr<test_type[]>(new test_type[size]),
+                       size};
+  if (interleave) srt::numa::interleave(res.data.get(), size * sizeof(test_type));
+
+  thread_local std::mt19937 g;
+  std::uniform_int_distribution<test_type> dis(0, max_gap);
+  test_type x = 0;
+  for (std::size_t i = 0; i != size; ++i) res.data[i] = x += dis(g);
+  return res;
+}
+
+void benchmark_parallel_merge(benchmark::State& state, std::size_t size,
+                              std::size_t threads, bool interleave) {
+  const std::size_t rhs_size = size / 100;
+  const std::size_t lhs_size = size - rhs_size;
+  const big_sorted_array lhs = big_sorted_array_data(lhs_size, 200, interleave);
+  const big_sorted_array rhs =
+      big_sorted_array_data(rhs_size, 200 * 100, interleave);
+
+  srt::parallel_merge_options options;
+  options.threads = threads;
+
+  // Not touched here: the first, untimed, merge places every slice of the
+  // output on the node of the worker that writes it.
+  std::unique_ptr<test_type[]> res(new test_type[size]);
+  srt::parallel_merge_biased(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                             res.get(), options);
+
+  for (auto _ : state) {
+    srt::parallel_merge_biased(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                               res.get(), options);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(
+      state.iterations() * 2 * size * sizeof(test_type)));
+}
+
+// Names are benchmark_parallel_merge<merge_biased>/size/threads with
+// /interleaved for inputs spread over all NUMA nodes.
+// The big parallel merges only run when asked for: with
+// --merge_parallel_sizes or --merge_algorithms=merge_biased.
+std::vector<std::size_t> parallel_sizes() {
+  const merge_benchmark_options& opts = options();
+  if (!opts.parallel_sizes.empty()) return opts.parallel_sizes;
+  if (std::find(opts.algorithms.begin(), opts.algorithms.end(),
+                "merge_biased") != opts.algorithms.end()) {
+    return {kParallelProblemSize};
+  }
+  return {};
+}
+
+void register_parallel_merge_benchmarks() {
+  const merge_benchmark_options& opts = options();
+
+  std::vector<std::size_t> threads_list = opts.threads;
+  if (threads_list.empty()) {
+    threads_list = {1, srt::parallel_merge_options{}.threads};
+  }
+
+  for (bool interleave : {false, true}) {
+    for (std::size_t size : parallel_sizes()) {
+      for (std::size_t threads : threads_list) {
+        std::string name = "benchmark_parallel_merge<merge_biased>/" +
+                           std::to_string(size) + "/" +
+                           std::to_string(threads);
+        if (interleave) name += "/interleaved";
+        benchmark::RegisterBenchmark(name.c_str(), benchmark_parallel_merge,
+                                     size, threads, interleave)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+      }
+    }
+  }
+}
+
+template <typename Merger>
+void benchmark_merge_batched(benchmark::State& state) {
+  const size_t base_size = static_cast<size_t>(state.range(0));
+  const size_t batch_count = static_cast<size_t>(state.range(1));
+  const size_t batch_size = static_cast<size_t>(state.range(2));
+
+  const test_batched_merge_input& input =
+      batched_input_data(base_size, batch_count, batch_size);
+  for (auto _ : state) {
+    test_type_vec res(base_size + batch_count * batch_size);
+    Merger{}(input.first.begin(), input.first.end(), input.second.begin(),
+             input.second.end(), res.begin());
+  }
+}
+
+BENCHMARK_TEMPLATE(benchmark_merge_batched, merge_biased_batched)
+    ->Apply(set_batched_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_merge_batched, sequential_merge_biased)
+    ->Apply(set_batched_benchmark_input_sizes);
+
+void set_first_k_benchmark_input_sizes(benchmark::internal::Benchmark* bench) {
+  for (std::size_t k = 10; k <= kProblemSize * 10; k *= 10) {
+    bench->Args({static_cast<int>(kProblemSize * 100),
+                 static_cast<int>(kProblemSize), static_cast<int>(k)});
+  }
+}
+
+template <typename Consumer>
+void benchmark_merge_first_k(benchmark::State& state) {
   const size_t lhs_size = static_cast<size_t>(state.range(0));
   const size_t rhs_size = static_cast<size_t>(state.range(1));
+  const size_t k = static_cast<size_t>(state.range(2));
+
+  const test_merge_input& input = input_data(lhs_size, rhs_size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Consumer{}(input.first.begin(), input.first.end(),
+                                        input.second.begin(),
+                                        input.second.end(), k));
+  }
+}
+
+BENCHMARK_TEMPLATE(benchmark_merge_first_k, first_k_full_merge)
+    ->Apply(set_first_k_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_merge_first_k, first_k_view)
+    ->Apply(set_first_k_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_merge_first_k, first_k_view_runs)
+    ->Apply(set_first_k_benchmark_input_sizes);
+
+namespace {
+
+using test_type_list = std::list<test_type>;
+
+constexpr std::size_t kListProblemSize = kProblemSize * 10;
+
+void set_list_benchmark_input_sizes(benchmark::internal::Benchmark* bench) {
+  for (std::size_t rhs_size = 1; rhs_size <= kListProblemSize / 2;
+       rhs_size *= 10) {
+    bench->Args({static_cast<int>(kListProblemSize - rhs_size),
+                 static_cast<int>(rhs_size)});
+  }
+}
+
+const std::pair<test_type_list, test_type_list>& list_input_data(
+    std::size_t lhs_size, std::size_t rhs_size) {
+  static std::map<std::pair<std::size_t, std::size_t>,
+                  std::pair<test_type_list, test_type_list>>
+      cache;
+
+  auto key = std::make_pair(lhs_size, rhs_size);
+  auto in_cache = cache.find(key);
+  if (in_cache != cache.end()) return in_cache->second;
 
   const test_merge_input& input = input_data(lhs_size, rhs_size);
+  return cache
+      .insert({key,
+               {test_type_list(input.first.begin(), input.first.end()),
+                test_type_list(input.second.begin(), input.second.end())}})
+      .first->second;
+}
+
+}  // namespace
+
+// Merges from list iterators into a vector: merge_v8 is the old
+// middle()-based gallop, merge_biased gallops forward from where it is.
+template <typename Merger>
+void benchmark_merge_list(benchmark::State& state) {
+  const size_t lhs_size = static_cast<size_t>(state.range(0));
+  const size_t rhs_size = static_cast<size_t>(state.range(1));
+
+  const auto& input = list_input_data(lhs_size, rhs_size);
+  test_type_vec res(lhs_size + rhs_size);
   for (auto _ : state) {
-    test_type_vec res(lhs_size + rhs_size);
     Merger{}(input.first.begin(), input.first.end(), input.second.begin(),
              input.second.end(), res.begin());
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_TEMPLATE(benchmark_merge_list, std_merge)
+    ->Apply(set_list_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_merge_list, merge_linear)
+    ->Apply(set_list_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_merge_list, merge_v8)
+    ->Apply(set_list_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_merge_list, merge_biased)
+    ->Apply(set_list_benchmark_input_sizes);
+
+// In place: the lists are copied back with the timer paused.
+template <typename Merger>
+void benchmark_merge_list_splice(benchmark::State& state) {
+  const size_t lhs_size = static_cast<size_t>(state.range(0));
+  const size_t rhs_size = static_cast<size_t>(state.range(1));
+
+  const auto& input = list_input_data(lhs_size, rhs_size);
+  test_type_list lhs, rhs;
+  for (auto _ : state) {
+    state.PauseTiming();
+    lhs = input.first;
+    rhs = input.second;
+    state.ResumeTiming();
+
+    Merger{}(lhs, rhs);
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_TEMPLATE(benchmark_merge_list_splice, list_merge)
+    ->Apply(set_list_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_merge_list_splice, list_merge_biased)
+    ->Apply(set_list_benchmark_input_sizes);
+
+namespace {
+
+// Small side is a random subset of the big one: every element is found, so
+// includes goes through the whole small side.
+const test_merge_input& subset_input_data(std::size_t lhs_size,
+                                          std::size_t rhs_size) {
+  static std::map<std::pair<std::size_t, std::size_t>, test_merge_input> cache;
+
+  auto key = std::make_pair(lhs_size, rhs_size);
+  auto in_cache = cache.find(key);
+  if (in_cache != cache.end()) return in_cache->second;
+
+  test_type_vec lhs = random_test_type_sorted_vec(lhs_size);
+  test_type_vec rhs;
+  std::sample(lhs.begin(), lhs.end(), std::back_inserter(rhs), rhs_size,
+              std::mt19937{});
+  return cache.insert({key, {std::move(lhs), std::move(rhs)}}).first->second;
+}
+
+void set_intersection_benchmark_input_sizes(
+    benchmark::internal::Benchmark* bench) {
+  for (std::size_t rhs_size = 1; rhs_size <= kProblemSize * 10;
+       rhs_size *= 10) {
+    bench->Args({static_cast<int>(kProblemSize * 100),
+                 static_cast<int>(rhs_size)});
+  }
+}
+
+// Output iterator that only counts the assignments.
+struct counting_iterator {
+  using iterator_category = std::output_iterator_tag;
+  using value_type = void;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = void;
+
+  std::ptrdiff_t* count;
+
+  counting_iterator& operator*() { return *this; }
+  counting_iterator& operator++() { return *this; }
+  counting_iterator operator++(int) { return *this; }
+  counting_iterator& operator=(test_type) {
+    ++*count;
+    return *this;
+  }
+};
+
+struct std_set_intersection_count {
+  template <typename I1, typename I2>
+  std::ptrdiff_t operator()(I1 f1, I1 l1, I2 f2, I2 l2) {
+    std::ptrdiff_t res = 0;
+    std::set_intersection(f1, l1, f2, l2, counting_iterator{&res});
+    return res;
+  }
+};
+
+struct count_common_biased {
+  template <typename I1, typename I2>
+  std::ptrdiff_t operator()(I1 f1, I1 l1, I2 f2, I2 l2) {
+    return srt::count_common_biased(f1, l1, f2, l2);
+  }
+};
+
+// Without AVX2 same as count_common_biased.
+struct count_common_biased_scalar {
+  template <typename I1, typename I2>
+  std::ptrdiff_t operator()(I1 f1, I1 l1, I2 f2, I2 l2) {
+    return srt::count_common_biased(f1, l1, f2, l2, std::less<>{});
+  }
+};
+
+struct std_includes {
+  template <typename I1, typename I2>
+  bool operator()(I1 f1, I1 l1, I2 f2, I2 l2) {
+    return std::includes(f1, l1, f2, l2);
+  }
+};
+
+struct includes_biased {
+  template <typename I1, typename I2>
+  bool operator()(I1 f1, I1 l1, I2 f2, I2 l2) {
+    return srt::includes_biased(f1, l1, f2, l2);
+  }
+};
+
+struct includes_biased_scalar {
+  template <typename I1, typename I2>
+  bool operator()(I1 f1, I1 l1, I2 f2, I2 l2) {
+    return srt::includes_biased(f1, l1, f2, l2, std::less<>{});
+  }
+};
+
+}  // namespace
+
+template <typename Algorithm>
+void benchmark_intersection(benchmark::State& state) {
+  const size_t lhs_size = static_cast<size_t>(state.range(0));
+  const size_t rhs_size = static_cast<size_t>(state.range(1));
+
+  const test_merge_input& input = subset_input_data(lhs_size, rhs_size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Algorithm{}(input.first.begin(),
+                                         input.first.end(),
+                                         input.second.begin(),
+                                         input.second.end()));
+  }
+}
+
+BENCHMARK_TEMPLATE(benchmark_intersection, std_set_intersection_count)
+    ->Apply(set_intersection_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_intersection, count_common_biased)
+    ->Apply(set_intersection_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_intersection, count_common_biased_scalar)
+    ->Apply(set_intersection_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_intersection, std_includes)
+    ->Apply(set_intersection_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_intersection, includes_biased)
+    ->Apply(set_intersection_benchmark_input_sizes);
+BENCHMARK_TEMPLATE(benchmark_intersection, includes_biased_scalar)
+    ->Apply(set_intersection_benchmark_input_sizes);
+
+namespace {
+
+using join_output = std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t>>;
+
+constexpr std::size_t kFactTableSize = kProblemSize * 100;
+constexpr std::size_t kDimensionTableSize = kProblemSize;
+constexpr test_type kDimensionKeyStep = 100;
+
+// Dimension keys are unique multiples of kDimensionKeyStep. A fact key is a
+// random dimension key with probability selectivity / 1000, otherwise a key
+// that matches nothing.
+const test_merge_input& join_input_data(std::size_t selectivity) {
+  static std::map<std::size_t, test_merge_input> cache;
+
+  auto in_cache = cache.find(selectivity);
+  if (in_cache != cache.end()) return in_cache->second;
+
+  std::mt19937 g;
+  std::uniform_int_distribution<test_type> dimension_key(
+      0, static_cast<test_type>(kDimensionTableSize) - 1);
+  std::uniform_int_distribution<test_type> offset(1, kDimensionKeyStep - 1);
+  std::uniform_int_distribution<std::size_t> matches(0, 999);
+
+  test_type_vec facts(kFactTableSize);
+  for (test_type& key : facts) {
+    key = dimension_key(g) * kDimensionKeyStep;
+    if (matches(g) >= selectivity) key += offset(g);
+  }
+  std::sort(facts.begin(), facts.end());
+
+  test_type_vec dimensions(kDimensionTableSize);
+  for (std::size_t i = 0; i != dimensions.size(); ++i) {
+    dimensions[i] = static_cast<test_type>(i) * kDimensionKeyStep;
+  }
+
+  return cache.insert({selectivity, {std::move(facts), std::move(dimensions)}})
+      .first->second;
+}
+
+void set_join_benchmark_selectivities(benchmark::internal::Benchmark* bench) {
+  for (int selectivity : {0, 1, 10, 100, 1000}) bench->Arg(selectivity);
+}
+
+// The textbook sort-merge join, one comparison per step.
+struct linear_merge_join {
+  template <typename I1, typename I2, typename O>
+  O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+    const I1 b1 = f1;
+    const I2 b2 = f2;
+    while (f1 != l1 && f2 != l2) {
+      if (*f1 < *f2) {
+        ++f1;
+      } else if (*f2 < *f1) {
+        ++f2;
+      } else {
+        I1 group_l1 = f1;
+        while (group_l1 != l1 && *group_l1 == *f1) ++group_l1;
+        I2 group_l2 = f2;
+        while (group_l2 != l2 && *group_l2 == *f2) ++group_l2;
+        for (I1 i1 = f1; i1 != group_l1; ++i1) {
+          for (I2 i2 = f2; i2 != group_l2; ++i2) {
+            *o++ = std::make_pair(i1 - b1, i2 - b2);
+          }
+        }
+        f1 = group_l1;
+        f2 = group_l2;
+      }
+    }
+    return o;
+  }
+};
+
+struct merge_join_biased {
+  template <typename I1, typename I2, typename O>
+  O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+    return srt::merge_join_biased(f1, l1, f2, l2, o);
+  }
+};
+
+}  // namespace
+
+// Fact table join dimension table, selectivity in 1/1000 of the fact rows
+// that have a match.
+template <typename Join>
+void benchmark_merge_join(benchmark::State& state) {
+  const auto selectivity = static_cast<std::size_t>(state.range(0));
+
+  const test_merge_input& input = join_input_data(selectivity);
+  join_output res;
+  res.reserve(input.first.size());
+  for (auto _ : state) {
+    res.clear();
+    Join{}(input.first.begin(), input.first.end(), input.second.begin(),
+           input.second.end(), std::back_inserter(res));
+    benchmark::ClobberMemory();
+  }
+  state.counters["matches"] = static_cast<double>(res.size());
+}
+
+BENCHMARK_TEMPLATE(benchmark_merge_join, linear_merge_join)
+    ->Apply(set_join_benchmark_selectivities);
+BENCHMARK_TEMPLATE(benchmark_merge_join, merge_join_biased)
+    ->Apply(set_join_benchmark_selectivities);
+
+namespace {
+
+std::vector<std::string> split_list(const std::string& list) {
+  std::vector<std::string> res;
+  std::string::size_type f = 0;
+  while (f <= list.size()) {
+    auto l = std::min(list.find(',', f), list.size());
+    if (l != f) res.push_back(list.substr(f, l - f));
+    f = l + 1;
+  }
+  return res;
+}
+
+bool parse_size(const std::string& str, std::size_t* res) {
+  if (str.empty() ||
+      str.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
   }
+  *res = static_cast<std::size_t>(std::stoull(str));
+  return true;
 }
 
-BENCHMARK_TEMPLATE(benchmark_merge, std_merge)->Apply(set_benchmark_input_sizes);
\ No newline at end of file
+// Takes --merge_* flags out of argv, leaving the rest for google benchmark.
+bool parse_merge_options(int* argc, char** argv) {
+  merge_benchmark_options& opts = options();
+
+  auto flag_value = [](const std::string& arg, const std::string& flag,
+                       std::string* value) {
+    const std::string prefix = "--" + flag + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    *value = arg.substr(prefix.size());
+    return true;
+  };
+
+  int kept = 1;
+  for (int i = 1; i < *argc; ++i) {
+    const std::string arg = argv[i];
+    std::string value;
+    bool ok = true;
+
+    if (flag_value(arg, "merge_problem_sizes", &value)) {
+      opts.problem_sizes.clear();
+      for (const std::string& size_str : split_list(value)) {
+        std::size_t size = 0;
+        ok = ok && parse_size(size_str, &size);
+        opts.problem_sizes.push_back(size);
+      }
+    } else if (flag_value(arg, "merge_max_rhs_size", &value)) {
+      ok = parse_size(value, &opts.max_rhs_size);
+    } else if (flag_value(arg, "merge_steps", &value)) {
+      ok = parse_size(value, &opts.steps) && opts.steps != 0;
+    } else if (flag_value(arg, "merge_distributions", &value)) {
+      opts.distributions = split_list(value);
+      for (const std::string& distribution_str : opts.distributions) {
+        input_distribution distribution;
+        ok = ok &&
+             parse_enum(kDistributionNames, distribution_str, &distribution);
+      }
+    } else if (flag_value(arg, "merge_outputs", &value)) {
+      opts.outputs = split_list(value);
+      for (const std::string& output_str : opts.outputs) {
+        output_mode output;
+        ok = ok && parse_enum(kOutputModeNames, output_str, &output);
+      }
+    } else if (flag_value(arg, "merge_threads", &value)) {
+      opts.threads.clear();
+      for (const std::string& threads_str : split_list(value)) {
+        std::size_t threads = 0;
+        ok = ok && parse_size(threads_str, &threads) && threads != 0;
+        opts.threads.push_back(threads);
+      }
+    } else if (flag_value(arg, "merge_parallel_sizes", &value)) {
+      opts.parallel_sizes.clear();
+      for (const std::string& size_str : split_list(value)) {
+        std::size_t size = 0;
+        ok = ok && parse_size(size_str, &size);
+        opts.parallel_sizes.push_back(size);
+      }
+    } else if (flag_value(arg, "merge_input_placement", &value)) {
+      input_placement placement;
+      opts.input_placement = value;
+      ok = parse_enum(kInputPlacementNames, value, &placement);
+    } else if (flag_value(arg, "merge_algorithms", &value)) {
+      opts.algorithms = split_list(value);
+      for (const std::string& algorithm : opts.algorithms) {
+        bool known = false;
+        for_each_merger([&](const char* name, auto) {
+          known = known || algorithm == name;
+        });
+        ok = ok && known;
+      }
+    } else {
+      argv[kept++] = argv[i];
+      continue;
+    }
+
+    if (!ok) {
+      std::fprintf(stderr, "%s: invalid value for %s\n", argv[0], argv[i]);
+      return false;
+    }
+  }
+  *argc = kept;
+  return true;
+}
+
+std::string join_list(const std::vector<std::string>& list) {
+  std::string res;
+  for (const std::string& x : list) res += (res.empty() ? "" : ",") + x;
+  return res;
+}
+
+// Everything needed to reproduce the run ends up in the json "context".
+void add_merge_options_context() {
+  const merge_benchmark_options& opts = options();
+
+  auto sizes_list = [](const std::vector<std::size_t>& sizes) {
+    std::vector<std::string> res;
+    for (std::size_t size : sizes) res.push_back(std::to_string(size));
+    return join_list(res);
+  };
+
+  benchmark::AddCustomContext("merge_problem_sizes",
+                              sizes_list(opts.problem_sizes));
+  benchmark::AddCustomContext("merge_max_rhs_size",
+                              std::to_string(opts.max_rhs_size));
+  benchmark::AddCustomContext("merge_steps", std::to_string(opts.steps));
+  benchmark::AddCustomContext("merge_distributions",
+                              join_list(opts.distributions));
+  benchmark::AddCustomContext("merge_outputs", join_list(opts.outputs));
+  benchmark::AddCustomContext(
+      "merge_threads", opts.threads.empty() ? "1" : sizes_list(opts.threads));
+  benchmark::AddCustomContext("merge_input_placement", opts.input_placement);
+  benchmark::AddCustomContext("merge_parallel_sizes",
+                              sizes_list(parallel_sizes()));
+  benchmark::AddCustomContext("numa_nodes",
+                              std::to_string(srt::numa::node_count()));
+  benchmark::AddCustomContext(
+      "merge_algorithms",
+      opts.algorithms.empty() ? "all" : join_list(opts.algorithms));
+}
+
+std::string read_first_line(const char* path) {
+  std::ifstream in(path);
+  std::string res;
+  if (!std::getline(in, res)) return "unknown";
+  return res;
+}
+
+// "microcode", "model name" etc. of the first cpu.
+std::string cpuinfo_field(const std::string& field) {
+  std::ifstream in("/proc/cpuinfo");
+  for (std::string line; std::getline(in, line);) {
+    if (line.compare(0, field.size(), field) != 0) continue;
+    const std::size_t colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    if (line.find_first_not_of(" \t", field.size()) != colon) continue;
+    const std::size_t value = line.find_first_not_of(' ', colon + 1);
+    return value == std::string::npos ? "" : line.substr(value);
+  }
+  return "unknown";
+}
+
+std::string compiler_version() {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#else
+  return "unknown";
+#endif
+}
+
+// Code layout and the machine state change timings by a few percent: the
+// build and the cpu settings go to the json "context" too.
+void add_environment_context() {
+  benchmark::AddCustomContext("compiler", compiler_version());
+  benchmark::AddCustomContext("compile_flags", SRT_BENCHMARK_FLAGS);
+  benchmark::AddCustomContext("align_functions", SRT_BENCHMARK_ALIGN_FUNCTIONS);
+  benchmark::AddCustomContext("align_loops", SRT_BENCHMARK_ALIGN_LOOPS);
+  benchmark::AddCustomContext("cpu_model", cpuinfo_field("model name"));
+  benchmark::AddCustomContext("cpu_microcode", cpuinfo_field("microcode"));
+  benchmark::AddCustomContext(
+      "cpu_governor",
+      read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor"));
+
+  // intel_pstate has no_turbo, acpi-cpufreq has boost.
+  std::string boost =
+      read_first_line("/sys/devices/system/cpu/intel_pstate/no_turbo");
+  if (boost != "unknown") {
+    boost = boost == "0" ? "1" : "0";
+  } else {
+    boost = read_first_line("/sys/devices/system/cpu/cpufreq/boost");
+  }
+  benchmark::AddCustomContext("cpu_boost", boost);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (!parse_merge_options(&argc, argv)) return 1;
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+  register_merge_benchmarks();
+  register_parallel_merge_benchmarks();
+  add_merge_options_context();
+  add_environment_context();
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <iterator>
+
+#include "result.h"
+
+namespace srt {
+
+// A run of consecutive merged elements. Only one of the two ranges is not
+// empty, unless the merge is over.
+template <typename I1, typename I2>
+struct merge_biased_run {
+  I1 f1, l1;
+  I2 f2, l2;
+
+  bool empty() const { return f1 == l1 && f2 == l2; }
+};
+
+// Lazy merge_biased: elements are produced on demand, with no output buffer.
+// Single pass, like a generator: iterators share the view's state.
+//
+// next_run() returns whole stretches of one range at once: what the
+// galloping search found (plus the linear steps in front of it) for the
+// first range, one element or the tail for the second.
+template <typename I1, typename I2, typename P = detail::less>
+// requiers ForwardIterator<I1> && ForwardIterator<I2> &&
+//          Convertible<ReferenceType<I2>, ReferenceType<I1>> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+class merge_biased_view {
+ public:
+  using run = merge_biased_run<I1, I2>;
+
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename std::iterator_traits<I1>::value_type;
+    using difference_type = typename std::iterator_traits<I1>::difference_type;
+    using pointer = void;
+    using reference = typename std::iterator_traits<I1>::reference;
+
+    iterator() = default;
+    explicit iterator(merge_biased_view* view) : view_{view} {}
+
+    reference operator*() const { return view_->current(); }
+
+    iterator& operator++() {
+      view_->advance();
+      return *this;
+    }
+
+    // Single pass: there is no copy of the old position to return.
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& x, const iterator& y) {
+      return x.at_end() == y.at_end();
+    }
+
+    friend bool operator!=(const iterator& x, const iterator& y) {
+      return !(x == y);
+    }
+
+   private:
+    bool at_end() const { return view_ == nullptr || view_->done(); }
+
+    merge_biased_view* view_ = nullptr;
+  };
+
+  merge_biased_view(I1 f1, I1 l1, I2 f2, I2 l2, P p = P{})
+      : f1_{f1}, l1_{l1}, f2_{f2}, l2_{l2}, run_l1_{f1}, p_{p} {
+    settle();
+  }
+
+  iterator begin() { return iterator{this}; }
+  iterator end() { return iterator{}; }
+
+  bool done() const { return f1_ == l1_ && f2_ == l2_; }
+
+  run next_run() {
+    if (f1_ == l1_) return take_second_tail();
+    if (f2_ == l2_) return take_first_tail();
+
+    if (!from_first_) {
+      run res{l1_, l1_, f2_, std::next(f2_)};
+      ++f2_;
+      settle();
+      return res;
+    }
+
+    I1 f = f1_;
+    do {
+      f1_ = run_l1_;
+      settle();
+    } while (from_first_);
+    return run{f, f1_, l2_, l2_};
+  }
+
+ private:
+  // Same state machine as merge_biased: a comparison per element from the
+  // first range, but after a few of them in a row we gallop and everything
+  // before the boundary is taken without comparisons.
+  static constexpr int kLinearStepsAfterSecond = kMergeBiasedLinearSteps;
+  static constexpr int kLinearStepsAfterRun = kMergeBiasedLinearSteps + 1;
+
+  typename iterator::reference current() const {
+    if (from_first_) return *f1_;
+    return *f2_;
+  }
+
+  void advance() {
+    if (from_first_) ++f1_;
+    else ++f2_;
+    settle();
+  }
+
+  // Decides which range the current element comes from.
+  // [f1_, run_l1_) is known to go before *f2_.
+  void settle() {
+    if (f1_ == l1_) { from_first_ = false; return; }
+    if (f2_ == l2_ || f1_ != run_l1_) { from_first_ = true; return; }
+
+    if (!linear_steps_) {
+      run_l1_ = detail::find_boundary(
+          f1_, l1_, [&](const auto& x) { return !p_(*f2_, x); });
+      linear_steps_ = kLinearStepsAfterRun;
+      if (f1_ != run_l1_) { from_first_ = true; return; }
+    }
+
+    from_first_ = !p_(*f2_, *f1_);
+    if (!from_first_) { linear_steps_ = kLinearStepsAfterSecond; return; }
+    run_l1_ = std::next(f1_);
+    --linear_steps_;
+  }
+
+  run take_first_tail() {
+    run res{f1_, l1_, l2_, l2_};
+    f1_ = l1_;
+    settle();
+    return res;
+  }
+
+  run take_second_tail() {
+    run res{l1_, l1_, f2_, l2_};
+    f2_ = l2_;
+    settle();
+    return res;
+  }
+
+  I1 f1_, l1_;
+  I2 f2_, l2_;
+  I1 run_l1_;
+  P p_;
+  int linear_steps_ = kLinearStepsAfterRun;
+  bool from_first_ = false;
+};
+
+template <typename I1, typename I2, typename P>
+merge_biased_view<I1, I2, P> make_merge_biased_view(I1 f1, I1 l1, I2 f2, I2 l2,
+                                                    P p) {
+  return {f1, l1, f2, l2, p};
+}
+
+template <typename I1, typename I2>
+merge_biased_view<I1, I2> make_merge_biased_view(I1 f1, I1 l1, I2 f2, I2 l2) {
+  return {f1, l1, f2, l2};
+}
+
+}  // namespace srt
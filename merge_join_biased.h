@@ -0,0 +1,154 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "intersection_biased.h"
+#include "result.h"
+
+namespace srt {
+
+namespace detail {
+
+// Forward iterator that counts its increments: indices of the gallop results
+// without walking the skipped elements again.
+template <typename I>
+struct indexed_iterator {
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename std::iterator_traits<I>::value_type;
+  using difference_type = DifferenceType<I>;
+  using pointer = typename std::iterator_traits<I>::pointer;
+  using reference = typename std::iterator_traits<I>::reference;
+
+  I it;
+  difference_type index;
+
+  reference operator*() const { return *it; }
+
+  indexed_iterator& operator++() {
+    ++it;
+    ++index;
+    return *this;
+  }
+
+  indexed_iterator operator++(int) {
+    indexed_iterator res = *this;
+    ++*this;
+    return res;
+  }
+
+  friend bool operator==(const indexed_iterator& x,
+                         const indexed_iterator& y) {
+    return x.it == y.it;
+  }
+
+  friend bool operator!=(const indexed_iterator& x,
+                         const indexed_iterator& y) {
+    return !(x == y);
+  }
+};
+
+// index1 and index2 give the position of an iterator in its range.
+template <typename I1, typename I2, typename O, typename P, typename Index1,
+          typename Index2>
+O merge_join_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p, Index1 index1,
+                    Index2 index2) {
+  using index1_t = decltype(index1(f1));
+  using index2_t = decltype(index2(f2));
+
+  while (f1 != l1 && f2 != l2) {
+    f1 = partition_point_biased_checked(
+        f1, l1, [&](const auto& x) { return p(x, *f2); });
+    if (f1 == l1) break;
+
+    if (p(*f2, *f1)) {
+      f2 = partition_point_biased_checked(
+          f2, l2, [&](const auto& y) { return p(y, *f1); });
+      continue;
+    }
+
+    // *f1 and *f2 are equal: the groups are up to the first greater ones.
+    const I1 group_l1 = partition_point_biased_checked(
+        f1, l1, [&](const auto& x) { return !p(*f2, x); });
+    const I2 group_l2 = partition_point_biased_checked(
+        f2, l2, [&](const auto& y) { return !p(*f1, y); });
+
+    for (index1_t i1 = index1(f1); i1 != index1(group_l1); ++i1) {
+      for (index2_t i2 = index2(f2); i2 != index2(group_l2); ++i2) {
+        *o++ = std::pair<index1_t, index2_t>{i1, i2};
+      }
+    }
+
+    f1 = group_l1;
+    f2 = group_l2;
+  }
+
+  return o;
+}
+
+// Index of an iterator: a subtraction with random access, otherwise the
+// iterator is wrapped in an indexed_iterator.
+template <typename I>
+auto indexed_begin(I f) {
+  using category = typename std::iterator_traits<I>::iterator_category;
+  if constexpr (std::is_base_of<std::random_access_iterator_tag,
+                                category>::value) {
+    return f;
+  } else {
+    return indexed_iterator<I>{f, 0};
+  }
+}
+
+template <typename I>
+auto indexed_end(I l) {
+  using category = typename std::iterator_traits<I>::iterator_category;
+  if constexpr (std::is_base_of<std::random_access_iterator_tag,
+                                category>::value) {
+    return l;
+  } else {
+    // Compared by the iterator only: the gallop never returns l itself, the
+    // index of the end is never read.
+    return indexed_iterator<I>{l, 0};
+  }
+}
+
+template <typename I>
+auto index_in(I f) {
+  using category = typename std::iterator_traits<I>::iterator_category;
+  if constexpr (std::is_base_of<std::random_access_iterator_tag,
+                                category>::value) {
+    return [f](I it) { return it - f; };
+  } else {
+    return [](const indexed_iterator<I>& it) { return it.index; };
+  }
+}
+
+}  // namespace detail
+
+// Equi-join of two sorted ranges: for every pair of equal elements writes
+// (index in [f1, l1), index in [f2, l2)), ordered by the first index, then by
+// the second. Groups of equal elements on both sides give all the pairs.
+//
+// Meant for a big [f1, l1) (fact table) and a small [f2, l2) (dimension
+// table): stretches without a match are galloped over on both sides, so the
+// big range is mostly not looked at when few of its keys match. Without
+// random access the gallop still follows every link once, but only once.
+template <typename I1, typename I2, typename O, typename P>
+// requiers ForwardIterator<I1> && ForwardIterator<I2> &&
+//          OutputIterator<O, std::pair<DifferenceType<I1>,
+//                                      DifferenceType<I2>>> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+O merge_join_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+  return detail::merge_join_biased(
+      detail::indexed_begin(f1), detail::indexed_end(l1),
+      detail::indexed_begin(f2), detail::indexed_end(l2), o, p,
+      detail::index_in(f1), detail::index_in(f2));
+}
+
+template <typename I1, typename I2, typename O>
+O merge_join_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+  return merge_join_biased(f1, l1, f2, l2, o, detail::less{});
+}
+
+}  // namespace srt
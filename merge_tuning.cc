@@ -0,0 +1,205 @@
+// Picks merge_biased tuning parameters for this machine.
+//
+// Sweeps merge_biased<LinearSteps, LinearProbes> over a range of rhs sizes and
+// writes the fastest combination as a header:
+//
+//   ./merge_tuning --merge_tuning_out=merge_tuning.h
+//   cmake -DMERGE_TUNING_HEADER=$PWD/merge_tuning.h ..
+//
+// The best combination is the one with the smallest geometric mean of its
+// times relative to the defaults, so that every rhs size counts the same.
+// Google benchmark flags (--benchmark_min_time etc.) are passed through.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "result.h"
+
+namespace {
+
+constexpr std::size_t kProblemSize = 2000u;
+constexpr std::size_t kRhsSizes[] = {1,   2,   5,   10,  20,  40,
+                                     100, 200, 500, 1000, 2000};
+
+// LinearSteps in [0, kMaxLinearSteps], LinearProbes in
+// [kMinLinearProbes, kMinLinearProbes + kLinearProbesCount).
+constexpr int kMaxLinearSteps = 6;
+constexpr int kMinLinearProbes = 3;
+constexpr int kLinearProbesCount = 5;
+
+using test_type = std::int64_t;
+using test_type_vec = std::vector<test_type>;
+
+test_type_vec random_test_type_sorted_vec(std::size_t size) {
+  static std::mt19937 g;
+  std::uniform_int_distribution<test_type> dis(
+      1, static_cast<test_type>(kProblemSize) * 100);
+  test_type_vec res(size);
+  std::generate(res.begin(), res.end(), [&] { return dis(g); });
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+// Same input for every combination.
+const std::pair<test_type_vec, test_type_vec>& input_data(std::size_t rhs_size) {
+  static std::map<std::size_t, std::pair<test_type_vec, test_type_vec>> cache;
+  auto in_cache = cache.find(rhs_size);
+  if (in_cache != cache.end()) return in_cache->second;
+  return cache
+      .insert({rhs_size,
+               {random_test_type_sorted_vec(kProblemSize - rhs_size),
+                random_test_type_sorted_vec(rhs_size)}})
+      .first->second;
+}
+
+template <int LinearSteps, int LinearProbes>
+void benchmark_merge_tuned(benchmark::State& state, std::size_t rhs_size) {
+  const auto& input = input_data(rhs_size);
+  test_type_vec res(kProblemSize);
+  for (auto _ : state) {
+    srt::merge_biased<LinearSteps, LinearProbes>(
+        input.first.begin(), input.first.end(), input.second.begin(),
+        input.second.end(), res.begin());
+    benchmark::ClobberMemory();
+  }
+}
+
+using parameters = std::pair<int, int>;  // LinearSteps, LinearProbes
+
+std::string benchmark_name(parameters params, std::size_t rhs_size) {
+  return "benchmark_merge_tuned<" + std::to_string(params.first) + "," +
+         std::to_string(params.second) + ">/" +
+         std::to_string(kProblemSize - rhs_size) + "/" +
+         std::to_string(rhs_size);
+}
+
+std::map<std::string, parameters>& benchmark_parameters() {
+  static std::map<std::string, parameters> res;
+  return res;
+}
+
+template <int LinearSteps, int LinearProbes>
+void register_tuned() {
+  for (std::size_t rhs_size : kRhsSizes) {
+    const std::string name =
+        benchmark_name({LinearSteps, LinearProbes}, rhs_size);
+    benchmark_parameters()[name] = {LinearSteps, LinearProbes};
+    benchmark::RegisterBenchmark(
+        name.c_str(), benchmark_merge_tuned<LinearSteps, LinearProbes>,
+        rhs_size);
+  }
+}
+
+template <int LinearSteps, int... LinearProbes>
+void register_tuned_steps(std::integer_sequence<int, LinearProbes...>) {
+  (register_tuned<LinearSteps, kMinLinearProbes + LinearProbes>(), ...);
+}
+
+template <int... LinearSteps>
+void register_tuned_benchmarks(std::integer_sequence<int, LinearSteps...>) {
+  (register_tuned_steps<LinearSteps>(
+       std::make_integer_sequence<int, kLinearProbesCount>{}),
+   ...);
+}
+
+// Console output as usual, plus the times for choosing the parameters.
+class tuning_reporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& reports) override {
+    for (const Run& run : reports) {
+      if (run.error_occurred) continue;
+      times_[run.benchmark_name()] = run.GetAdjustedRealTime();
+    }
+    ConsoleReporter::ReportRuns(reports);
+  }
+
+  // Combination with the smallest sum of log(time / default time).
+  bool best(parameters* res) const {
+    const parameters defaults{srt::kMergeBiasedLinearSteps,
+                              srt::kPartitionPointLinearProbes};
+    std::map<parameters, double> scores;
+    for (const auto& [name, params] : benchmark_parameters()) {
+      const std::size_t rhs_size = std::stoull(name.substr(name.rfind('/') + 1));
+      auto time = times_.find(name);
+      auto default_time = times_.find(benchmark_name(defaults, rhs_size));
+      if (time == times_.end() || default_time == times_.end()) return false;
+      scores[params] += std::log(time->second / default_time->second);
+    }
+    if (scores.empty()) return false;
+
+    *res = std::min_element(scores.begin(), scores.end(),
+                            [](const auto& x, const auto& y) {
+                              return x.second < y.second;
+                            })
+               ->first;
+    return true;
+  }
+
+ private:
+  std::map<std::string, double> times_;
+};
+
+bool write_header(const std::string& path, parameters params) {
+  std::FILE* out = std::fopen(path.c_str(), "w");
+  if (!out) return false;
+  std::fprintf(out,
+               "#pragma once\n"
+               "\n"
+               "// Generated by merge_tuning, see merge_tuning.cc.\n"
+               "\n"
+               "#define SRT_MERGE_BIASED_LINEAR_STEPS %d\n"
+               "#define SRT_PARTITION_POINT_LINEAR_PROBES %d\n",
+               params.first, params.second);
+  return std::fclose(out) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string out_path = "merge_tuning.h";
+  const std::string out_flag = "--merge_tuning_out=";
+  int kept = 1;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.compare(0, out_flag.size(), out_flag) == 0) {
+      out_path = arg.substr(out_flag.size());
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  argc = kept;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+  register_tuned_benchmarks(
+      std::make_integer_sequence<int, kMaxLinearSteps + 1>{});
+
+  tuning_reporter reporter;
+  benchmark::RunSpecifiedBenchmarks(&reporter);
+  benchmark::Shutdown();
+
+  parameters best;
+  if (!reporter.best(&best)) {
+    std::fprintf(stderr,
+                 "%s: need every combination and the defaults measured\n",
+                 argv[0]);
+    return 1;
+  }
+  if (!write_header(out_path, best)) {
+    std::fprintf(stderr, "%s: can't write %s\n", argv[0], out_path.c_str());
+    return 1;
+  }
+  std::printf("LinearSteps: %d, LinearProbes: %d -> %s\n", best.first,
+              best.second, out_path.c_str());
+  return 0;
+}
@@ -1,12 +1,26 @@
 #include "third_party/catch.h"
 
 #include "result.h"
+#include "intersection_biased.h"
+#include "merge_biased_view.h"
+#include "merge_join_biased.h"
 #include "other_algorithms.h"
+#include "parallel_merge.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <forward_list>
+#include <functional>
 #include <iostream>
 #include <list>
+#include <memory_resource>
+#include <numeric>
 #include <random>
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+#include <sstream>
 #include <utility>
 #include <vector>
 
@@ -36,10 +50,11 @@ struct zeroed_int {
 };
 
 struct stability_less {
-  bool operator()(int x, int y) const { return x < y; }
+  constexpr bool operator()(int x, int y) const { return x < y; }
 
   template <typename T, typename U>
-  bool operator()(const std::pair<T, U>& x, const std::pair<T, U>& y) const {
+  constexpr bool operator()(const std::pair<T, U>& x,
+                            const std::pair<T, U>& y) const {
     return x.first < y.first;
   }
 };
@@ -265,4 +280,645 @@ TEST_CASE("result") {
   test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
     return srt::merge_biased(f1, l1, f2, l2, o);
   });
-}
\ No newline at end of file
+}
+
+TEST_CASE("merge_biased_tuning_parameters") {
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::merge_biased<0, 3>(f1, l1, f2, l2, o, stability_less{});
+  });
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::merge_biased<1, 4>(f1, l1, f2, l2, o, stability_less{});
+  });
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::merge_biased<6, 7>(f1, l1, f2, l2, o, stability_less{});
+  });
+}
+
+TEST_CASE("merge_biased_adaptive") {
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::merge_biased_adaptive(f1, l1, f2, l2, o, stability_less{});
+  });
+
+  auto merger = [](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::merge_biased_adaptive(f1, l1, f2, l2, o, stability_less{});
+  };
+
+  // From prepended through overlapping at the edges to appended, with equal
+  // elements at the boundaries.
+  for (int offset = -40; offset <= 40; ++offset) {
+    std::vector<int> lhs(50);
+    for (int i = 0; i != 50; ++i) lhs[i] = i / 2;
+    std::vector<int> rhs(20);
+    for (int i = 0; i != 20; ++i) rhs[i] = offset + i / 2;
+
+    run_plain_test(lhs, rhs, merger);
+    run_plain_test(rhs, lhs, merger);
+  }
+
+  // Bulk copies with memcpy.
+  std::vector<std::int64_t> lhs(100);
+  std::iota(lhs.begin(), lhs.end(), 0);
+  std::vector<std::int64_t> rhs{-3, -1, 0, 5, 99, 100, 150};
+  std::vector<std::int64_t> expected(lhs.size() + rhs.size());
+  std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), expected.begin());
+
+  std::vector<std::int64_t> actual(expected.size());
+  REQUIRE(srt::merge_biased_adaptive(lhs.begin(), lhs.end(), rhs.begin(),
+                                     rhs.end(), actual.begin()) ==
+          actual.end());
+  REQUIRE(expected == actual);
+
+  std::fill(actual.begin(), actual.end(), 0);
+  const std::int64_t* lhs_data = lhs.data();
+  REQUIRE(srt::merge_biased_adaptive(lhs_data, lhs_data + lhs.size(),
+                                     rhs.data(), rhs.data() + rhs.size(),
+                                     actual.data()) ==
+          actual.data() + actual.size());
+  REQUIRE(expected == actual);
+}
+
+TEST_CASE("merge_biased_iterator_categories") {
+  using value_type = std::pair<int, int>;
+
+  const auto& test_ints = test_data();
+
+  // Few distinct values: the forward gallop stops on equal elements a lot.
+  for (int modulo : {1, 3, int(kTestSize) * 100}) {
+    for (std::size_t lhs_size = 0; lhs_size <= kTestSize; lhs_size += 7) {
+      for (std::size_t rhs_size = 0; rhs_size <= 20; ++rhs_size) {
+        std::vector<value_type> lhs(lhs_size), rhs(rhs_size);
+        std::transform(test_ints.begin(), test_ints.begin() + lhs_size,
+                       lhs.begin(),
+                       [&](int x) { return value_type{x % modulo, 0}; });
+        std::transform(test_ints.end() - rhs_size, test_ints.end(),
+                       rhs.begin(),
+                       [&](int x) { return value_type{x % modulo, 1}; });
+        std::sort(lhs.begin(), lhs.end());
+        std::sort(rhs.begin(), rhs.end());
+
+        std::vector<value_type> expected(lhs_size + rhs_size);
+        std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                   expected.begin(), stability_less{});
+
+        std::forward_list<value_type> lhs_list(lhs.begin(), lhs.end());
+        std::forward_list<value_type> rhs_list(rhs.begin(), rhs.end());
+        std::vector<value_type> actual(lhs_size + rhs_size);
+        srt::merge_biased(lhs_list.begin(), lhs_list.end(), rhs_list.begin(),
+                          rhs_list.end(), actual.begin(), stability_less{});
+        REQUIRE(expected == actual);
+
+        srt::merge_biased<0, 3>(lhs_list.begin(), lhs_list.end(),
+                                rhs_list.begin(), rhs_list.end(),
+                                actual.begin(), stability_less{});
+        REQUIRE(expected == actual);
+      }
+    }
+  }
+
+  // Input iterators fall back to merge_linear.
+  std::istringstream lhs_stream("1 3 3 5 8 13");
+  std::vector<int> rhs{2, 3, 4, 13, 21};
+  std::vector<int> actual;
+  srt::merge_biased(std::istream_iterator<int>(lhs_stream),
+                    std::istream_iterator<int>(), rhs.begin(), rhs.end(),
+                    std::back_inserter(actual));
+  REQUIRE(actual == std::vector<int>{1, 2, 3, 3, 3, 4, 5, 8, 13, 13, 21});
+}
+
+TEST_CASE("merge_biased_list_splice") {
+  using value_type = std::pair<int, int>;
+
+  const auto& test_ints = test_data();
+
+  for (int modulo : {3, int(kTestSize) * 100}) {
+    for (std::size_t total_size = 0; total_size <= kTestSize; ++total_size) {
+      for (std::size_t lhs_size = 0; lhs_size <= total_size; ++lhs_size) {
+        std::vector<value_type> lhs(lhs_size), rhs(total_size - lhs_size);
+        std::transform(test_ints.begin(), test_ints.begin() + lhs_size,
+                       lhs.begin(),
+                       [&](int x) { return value_type{x % modulo, 0}; });
+        std::transform(test_ints.begin() + lhs_size,
+                       test_ints.begin() + total_size, rhs.begin(),
+                       [&](int x) { return value_type{x % modulo, 1}; });
+        std::sort(lhs.begin(), lhs.end());
+        std::sort(rhs.begin(), rhs.end());
+
+        std::vector<value_type> expected(total_size);
+        std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                   expected.begin(), stability_less{});
+
+        std::list<value_type> lhs_list(lhs.begin(), lhs.end());
+        std::list<value_type> rhs_list(rhs.begin(), rhs.end());
+        const value_type* rhs_node =
+            rhs_list.empty() ? nullptr : &rhs_list.back();
+
+        srt::merge_biased(lhs_list, rhs_list, stability_less{});
+
+        REQUIRE(rhs_list.empty());
+        REQUIRE(expected == std::vector<value_type>(lhs_list.begin(),
+                                                    lhs_list.end()));
+        if (rhs_node) {
+          // Relinked, not copied.
+          REQUIRE(std::any_of(lhs_list.begin(), lhs_list.end(),
+                              [&](const value_type& x) {
+                                return &x == rhs_node;
+                              }));
+        }
+      }
+    }
+  }
+
+  // Like std::list::merge: merging a list with itself does nothing.
+  std::list<int> self{1, 2, 2, 3};
+  srt::merge_biased(self, self);
+  REQUIRE(self == std::list<int>{1, 2, 2, 3});
+}
+
+namespace {
+
+struct counting_iterator {
+  using iterator_category = std::output_iterator_tag;
+  using value_type = void;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = void;
+
+  std::ptrdiff_t* count;
+
+  counting_iterator& operator*() { return *this; }
+  counting_iterator& operator++() { return *this; }
+  counting_iterator operator++(int) { return *this; }
+
+  template <typename T>
+  counting_iterator& operator=(const T&) {
+    ++*count;
+    return *this;
+  }
+};
+
+// Forward iterator over a vector that counts its increments.
+struct stepping_iterator {
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::int64_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const std::int64_t*;
+  using reference = const std::int64_t&;
+
+  std::vector<std::int64_t>::const_iterator it;
+  std::ptrdiff_t* steps = nullptr;
+
+  reference operator*() const { return *it; }
+  stepping_iterator& operator++() {
+    ++it;
+    ++*steps;
+    return *this;
+  }
+  stepping_iterator operator++(int) {
+    stepping_iterator res = *this;
+    ++*this;
+    return res;
+  }
+  friend bool operator==(const stepping_iterator& x,
+                         const stepping_iterator& y) {
+    return x.it == y.it;
+  }
+  friend bool operator!=(const stepping_iterator& x,
+                         const stepping_iterator& y) {
+    return !(x == y);
+  }
+};
+
+template <typename T>
+void test_intersection_biased(const std::vector<T>& lhs,
+                              const std::vector<T>& rhs) {
+  std::ptrdiff_t expected_count = 0;
+  std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                        counting_iterator{&expected_count});
+  const bool expected_includes =
+      std::includes(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+
+  REQUIRE(expected_count ==
+          srt::count_common_biased(lhs.begin(), lhs.end(), rhs.begin(),
+                                   rhs.end()));
+  REQUIRE(expected_includes == srt::includes_biased(lhs.begin(), lhs.end(),
+                                                    rhs.begin(), rhs.end()));
+
+  REQUIRE(expected_count == srt::count_common_biased(
+                                lhs.begin(), lhs.end(), rhs.begin(),
+                                rhs.end(), std::less<>{}));
+  REQUIRE(expected_includes ==
+          srt::includes_biased(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                               std::less<>{}));
+
+  std::list<T> lhs_list(lhs.begin(), lhs.end());
+  REQUIRE(expected_count ==
+          srt::count_common_biased(lhs_list.begin(), lhs_list.end(),
+                                   rhs.begin(), rhs.end()));
+  REQUIRE(expected_includes ==
+          srt::includes_biased(lhs_list.begin(), lhs_list.end(), rhs.begin(),
+                               rhs.end()));
+}
+
+}  // namespace
+
+TEST_CASE("intersection_biased") {
+  const auto& test_ints = test_data();
+
+  for (int modulo : {2, 10, int(kTestSize) * 100}) {
+    for (std::size_t lhs_size = 0; lhs_size <= kTestSize; lhs_size += 3) {
+      for (std::size_t rhs_size = 0; rhs_size <= 30; ++rhs_size) {
+        std::vector<std::int64_t> lhs(lhs_size);
+        std::transform(test_ints.begin(), test_ints.begin() + lhs_size,
+                       lhs.begin(), [&](int x) { return x % modulo; });
+        std::sort(lhs.begin(), lhs.end());
+
+        // Half of the time a subset of lhs, for includes to be true.
+        std::vector<std::int64_t> rhs;
+        if (rhs_size % 2 && lhs_size) {
+          for (std::size_t i = 0; i != rhs_size; ++i) {
+            rhs.push_back(lhs[static_cast<std::size_t>(test_ints[i]) %
+                              lhs_size]);
+          }
+          std::sort(rhs.begin(), rhs.end());
+          rhs.erase(std::unique(rhs.begin(), rhs.end()), rhs.end());
+        } else {
+          rhs.resize(rhs_size);
+          std::transform(test_ints.end() - rhs_size, test_ints.end(),
+                         rhs.begin(), [&](int x) { return x % modulo; });
+          std::sort(rhs.begin(), rhs.end());
+        }
+
+        test_intersection_biased(lhs, rhs);
+        test_intersection_biased(std::vector<int>(lhs.begin(), lhs.end()),
+                                 std::vector<int>(rhs.begin(), rhs.end()));
+      }
+    }
+  }
+}
+
+TEST_CASE("merge_join_biased") {
+  using index_pair = std::pair<std::ptrdiff_t, std::ptrdiff_t>;
+
+  const auto& test_ints = test_data();
+
+  for (int modulo : {1, 5, 50, int(kTestSize) * 100}) {
+    for (std::size_t lhs_size = 0; lhs_size <= kTestSize; lhs_size += 3) {
+      for (std::size_t rhs_size = 0; rhs_size <= 20; ++rhs_size) {
+        std::vector<std::int64_t> lhs(lhs_size), rhs(rhs_size);
+        std::transform(test_ints.begin(), test_ints.begin() + lhs_size,
+                       lhs.begin(), [&](int x) { return x % modulo; });
+        std::transform(test_ints.end() - rhs_size, test_ints.end(),
+                       rhs.begin(), [&](int x) { return x % modulo; });
+        std::sort(lhs.begin(), lhs.end());
+        std::sort(rhs.begin(), rhs.end());
+
+        std::vector<index_pair> expected;
+        for (std::size_t i = 0; i != lhs.size(); ++i) {
+          for (std::size_t j = 0; j != rhs.size(); ++j) {
+            if (lhs[i] == rhs[j]) {
+              expected.emplace_back(static_cast<std::ptrdiff_t>(i),
+                                    static_cast<std::ptrdiff_t>(j));
+            }
+          }
+        }
+
+        std::vector<index_pair> actual;
+        srt::merge_join_biased(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                               std::back_inserter(actual));
+        REQUIRE(expected == actual);
+
+        std::list<std::int64_t> rhs_list(rhs.begin(), rhs.end());
+        actual.clear();
+        srt::merge_join_biased(lhs.begin(), lhs.end(), rhs_list.begin(),
+                               rhs_list.end(), std::back_inserter(actual),
+                               std::less<>{});
+        REQUIRE(expected == actual);
+
+        std::forward_list<std::int64_t> lhs_list(lhs.begin(), lhs.end());
+        actual.clear();
+        srt::merge_join_biased(lhs_list.begin(), lhs_list.end(),
+                               rhs_list.begin(), rhs_list.end(),
+                               std::back_inserter(actual));
+        REQUIRE(expected == actual);
+      }
+    }
+  }
+
+  // Without random access every element is stepped over about once: the
+  // indices are not recomputed by walking the galloped over stretches.
+  std::vector<std::int64_t> lhs(10000);
+  std::iota(lhs.begin(), lhs.end(), 0);
+  const std::vector<std::int64_t> rhs{5000, 9999};
+  std::ptrdiff_t steps = 0;
+  std::vector<index_pair> actual;
+  srt::merge_join_biased(stepping_iterator{lhs.begin(), &steps},
+                         stepping_iterator{lhs.end(), &steps}, rhs.begin(),
+                         rhs.end(), std::back_inserter(actual));
+  REQUIRE(actual == std::vector<index_pair>{{5000, 0}, {9999, 1}});
+  REQUIRE(steps <= static_cast<std::ptrdiff_t>(lhs.size()) + 100);
+}
+
+TEST_CASE("merge_biased_batched") {
+  using value_type = std::pair<int, int>;
+  const auto& test_ints = test_data();
+
+  for (std::size_t base_size : {0u, 1u, 7u, 100u}) {
+    for (std::size_t batch_count = 0; batch_count <= 9; ++batch_count) {
+      for (std::size_t batch_size : {0u, 1u, 3u, 10u}) {
+        std::vector<value_type> base;
+        std::vector<std::vector<value_type>> batches(batch_count);
+
+        auto it = test_ints.begin();
+        for (std::size_t i = 0; i < base_size; ++i) {
+          base.emplace_back(*it++ % 50, 0);
+        }
+        for (std::size_t b = 0; b < batch_count; ++b) {
+          for (std::size_t i = 0; i < batch_size; ++i) {
+            batches[b].emplace_back(*it++ % 50, static_cast<int>(b) + 1);
+          }
+          std::sort(batches[b].begin(), batches[b].end());
+        }
+        std::sort(base.begin(), base.end());
+
+        std::vector<value_type> expected = base;
+        for (const auto& batch : batches) {
+          expected.insert(expected.end(), batch.begin(), batch.end());
+        }
+        std::stable_sort(expected.begin(), expected.end(), stability_less{});
+
+        std::vector<value_type> actual;
+        srt::merge_biased_batched(base.begin(), base.end(), batches.begin(),
+                                  batches.end(), std::back_inserter(actual),
+                                  stability_less{});
+        REQUIRE(expected == actual);
+      }
+    }
+  }
+
+  // No default constructor.
+  const std::vector<int> ints{1, 2, 3, 4, 5, 6, 7, 8};
+  using ref = std::reference_wrapper<const int>;
+  const std::vector<ref> base{ints[0], ints[3], ints[7]};
+  const std::vector<std::vector<ref>> batches{
+      {ints[1], ints[5]}, {ints[2]}, {ints[4], ints[6]}};
+  std::vector<ref> actual;
+  srt::merge_biased_batched(base.begin(), base.end(), batches.begin(),
+                            batches.end(), std::back_inserter(actual),
+                            std::less<int>{});
+  REQUIRE(std::equal(ints.begin(), ints.end(), actual.begin(), actual.end(),
+                     [](int x, int y) { return x == y; }));
+}
+
+TEST_CASE("merge_biased_view") {
+  using value_type = std::pair<int, int>;
+  const auto& test_ints = test_data();
+
+  for (std::size_t total_size = 0; total_size <= kTestSize; total_size += 3) {
+    for (std::size_t lhs_size = 0; lhs_size <= total_size; ++lhs_size) {
+      std::vector<value_type> lhs, rhs;
+      for (std::size_t i = 0; i < lhs_size; ++i) {
+        lhs.emplace_back(test_ints[i] % 100, 0);
+      }
+      for (std::size_t i = lhs_size; i < total_size; ++i) {
+        rhs.emplace_back(test_ints[i] % 100, 1);
+      }
+      std::sort(lhs.begin(), lhs.end());
+      std::sort(rhs.begin(), rhs.end());
+
+      std::vector<value_type> expected;
+      std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                 std::back_inserter(expected), stability_less{});
+
+      {
+        auto view = srt::make_merge_biased_view(
+            lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), stability_less{});
+        std::vector<value_type> actual(view.begin(), view.end());
+        REQUIRE(expected == actual);
+      }
+
+      {
+        auto view = srt::make_merge_biased_view(
+            lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), stability_less{});
+        std::vector<value_type> actual;
+        for (auto run = view.next_run(); !run.empty(); run = view.next_run()) {
+          REQUIRE(((run.f1 == run.l1) != (run.f2 == run.l2)));
+          actual.insert(actual.end(), run.f1, run.l1);
+          actual.insert(actual.end(), run.f2, run.l2);
+        }
+        REQUIRE(expected == actual);
+      }
+
+      // Mixing element by element and bulk consumption.
+      {
+        auto view = srt::make_merge_biased_view(
+            lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), stability_less{});
+        std::vector<value_type> actual;
+        for (bool by_element = true; !view.done(); by_element = !by_element) {
+          if (by_element) {
+            actual.push_back(*view.begin());
+            ++view.begin();
+            continue;
+          }
+          auto run = view.next_run();
+          actual.insert(actual.end(), run.f1, run.l1);
+          actual.insert(actual.end(), run.f2, run.l2);
+        }
+        REQUIRE(expected == actual);
+      }
+    }
+  }
+}
+
+#if defined(__cpp_lib_ranges)
+TEST_CASE("merge_biased_view_ranges") {
+  using view_t = srt::merge_biased_view<std::vector<int>::iterator,
+                                        std::vector<int>::iterator>;
+  static_assert(std::input_iterator<view_t::iterator>);
+  static_assert(std::ranges::input_range<view_t>);
+
+  std::vector<int> lhs(100);
+  std::iota(lhs.begin(), lhs.end(), 0);
+  std::vector<int> rhs{3, 50, 200};
+
+  // Top k: only the first k elements of the merge are produced.
+  auto view = srt::make_merge_biased_view(lhs.begin(), lhs.end(), rhs.begin(),
+                                          rhs.end());
+  std::vector<int> actual;
+  std::ranges::copy(view | std::views::take(6), std::back_inserter(actual));
+  REQUIRE(actual == std::vector<int>{0, 1, 2, 3, 3, 4});
+
+  // Next page from the same view.
+  actual.clear();
+  std::ranges::copy(view | std::views::take(3), std::back_inserter(actual));
+  REQUIRE(actual == std::vector<int>{5, 6, 7});
+}
+#endif
+
+TEST_CASE("merge_biased_into") {
+  const auto& test_ints = test_data();
+
+  std::vector<int> lhs(test_ints.begin(), test_ints.begin() + 150);
+  std::vector<int> rhs(test_ints.begin() + 150, test_ints.end());
+  std::sort(lhs.begin(), lhs.end());
+  std::sort(rhs.begin(), rhs.end());
+
+  std::vector<int> expected(lhs.size() + rhs.size());
+  std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), expected.begin());
+
+  // Allocating past the buffer throws.
+  std::vector<int> buffer(expected.size() * 4);
+  std::pmr::monotonic_buffer_resource resource(
+      buffer.data(), buffer.size() * sizeof(int),
+      std::pmr::null_memory_resource());
+  std::pmr::vector<int> actual(&resource);
+  actual.reserve(expected.size() * 2);
+  const int* data = actual.data();
+
+  auto appended =
+      srt::merge_biased_into(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                             actual);
+  REQUIRE(appended == actual.begin());
+  REQUIRE(std::equal(expected.begin(), expected.end(), actual.begin(),
+                     actual.end()));
+
+  appended = srt::merge_biased_into(lhs.begin(), lhs.end(), rhs.begin(),
+                                    rhs.end(), actual, stability_less{});
+  REQUIRE(appended == actual.begin() + expected.size());
+  REQUIRE(std::equal(expected.begin(), expected.end(), appended,
+                     actual.end()));
+
+  // Capacity is reused.
+  actual.clear();
+  srt::merge_biased_into(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                         actual);
+  REQUIRE(actual.data() == data);
+  REQUIRE(std::equal(expected.begin(), expected.end(), actual.begin(),
+                     actual.end()));
+
+  // Without resize: no default constructor, a list.
+  std::vector<std::reference_wrapper<const int>> refs{expected.front()};
+  auto refs_appended = srt::merge_biased_into(
+      lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), refs,
+      [](const auto& x, const auto& y) {
+        return static_cast<const int&>(x) < static_cast<const int&>(y);
+      });
+  REQUIRE(refs_appended == refs.begin() + 1);
+  REQUIRE(std::equal(expected.begin(), expected.end(), refs_appended,
+                     refs.end(), [](int x, int y) { return x == y; }));
+
+  std::list<int> list{-1};
+  auto list_appended = srt::merge_biased_into(lhs.begin(), lhs.end(),
+                                              rhs.begin(), rhs.end(), list);
+  REQUIRE(list_appended == std::next(list.begin()));
+  REQUIRE(std::equal(expected.begin(), expected.end(), list_appended,
+                     list.end()));
+}
+
+TEST_CASE("parallel_merge_biased") {
+  for (std::size_t threads = 1; threads <= 5; ++threads) {
+    srt::parallel_merge_options options;
+    options.threads = threads;
+
+    test_merge([&](auto f1, auto l1, auto f2, auto l2, auto o) {
+      // The output has to be random access: merge into a buffer first.
+      using value_type = typename std::iterator_traits<decltype(f1)>::value_type;
+      std::vector<value_type> lhs(f1, l1);
+      std::vector<value_type> rhs(f2, l2);
+      std::vector<value_type> res(lhs.size() + rhs.size());
+      srt::parallel_merge_biased(
+          std::make_move_iterator(lhs.begin()),
+          std::make_move_iterator(lhs.end()),
+          std::make_move_iterator(rhs.begin()),
+          std::make_move_iterator(rhs.end()), res.begin(), stability_less{},
+          options);
+      return std::move(res.begin(), res.end(), o);
+    });
+  }
+}
+
+#if defined(__cpp_lib_is_constant_evaluated)
+
+namespace {
+
+using constexpr_test_t = std::pair<int, int>;
+
+template <std::size_t N>
+constexpr std::array<constexpr_test_t, N> constexpr_test_data(int first,
+                                                              int step,
+                                                              int tag) {
+  std::array<constexpr_test_t, N> res{};
+  for (std::size_t i = 0; i != N; ++i) {
+    res[i] = {first + static_cast<int>(i / 3) * step, tag};
+  }
+  return res;
+}
+
+template <std::size_t N, std::size_t M, typename Merger>
+constexpr bool constexpr_merge_test(
+    const std::array<constexpr_test_t, N>& lhs,
+    const std::array<constexpr_test_t, M>& rhs, Merger merger) {
+  std::array<constexpr_test_t, N + M> expected{};
+  std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), expected.begin(),
+             stability_less{});
+
+  std::array<constexpr_test_t, N + M> actual{};
+  merger(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), actual.begin());
+  return expected == actual;
+}
+
+template <typename Merger>
+constexpr bool constexpr_merge_tests(Merger merger) {
+  constexpr auto big = constexpr_test_data<300>(0, 2, 0);
+  constexpr auto small = constexpr_test_data<7>(1, 90, 1);
+  constexpr auto dense = constexpr_test_data<40>(0, 1, 1);
+  constexpr std::array<constexpr_test_t, 0> empty{};
+
+  return constexpr_merge_test(big, small, merger) &&
+         constexpr_merge_test(small, big, merger) &&
+         constexpr_merge_test(big, dense, merger) &&
+         constexpr_merge_test(dense, big, merger) &&
+         constexpr_merge_test(big, empty, merger) &&
+         constexpr_merge_test(empty, small, merger) &&
+         constexpr_merge_test(empty, empty, merger);
+}
+
+static_assert(constexpr_merge_tests([](auto f1, auto l1, auto f2, auto l2,
+                                       auto o) {
+                return srt::merge_linear(f1, l1, f2, l2, o, stability_less{});
+              }),
+              "");
+
+static_assert(constexpr_merge_tests([](auto f1, auto l1, auto f2, auto l2,
+                                       auto o) {
+                return srt::merge_biased(f1, l1, f2, l2, o, stability_less{});
+              }),
+              "");
+
+}  // namespace
+
+TEST_CASE("constexpr_result") {
+  // The goto free versions are only reachable in constant evaluation,
+  // check them at runtime too.
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::detail::merge_linear_constexpr(f1, l1, f2, l2, o,
+                                               stability_less{});
+  });
+
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::detail::merge_biased_constexpr<
+        srt::kMergeBiasedLinearSteps, srt::kPartitionPointLinearProbes>(
+        f1, l1, f2, l2, o, stability_less{});
+  });
+
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::detail::merge_biased_constexpr<0, 3>(f1, l1, f2, l2, o,
+                                                     stability_less{});
+  });
+
+  test_merge([](auto f1, auto l1, auto f2, auto l2, auto o) {
+    return srt::detail::merge_biased_constexpr<5, 4>(f1, l1, f2, l2, o,
+                                                     stability_less{});
+  });
+}
+
+#endif  // defined(__cpp_lib_is_constant_evaluated)
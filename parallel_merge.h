@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(SRT_HAVE_LIBNUMA)
+#include <numa.h>
+#endif
+
+#include "result.h"
+
+namespace srt {
+
+namespace numa {
+
+// libnuma when the build found it (SRT_HAVE_LIBNUMA), otherwise a single node
+// and no-ops.
+
+inline bool available() {
+#if defined(SRT_HAVE_LIBNUMA)
+  return numa_available() != -1;
+#else
+  return false;
+#endif
+}
+
+inline int node_count() {
+#if defined(SRT_HAVE_LIBNUMA)
+  if (available()) return numa_num_configured_nodes();
+#endif
+  return 1;
+}
+
+// Moves the calling thread to the cpus of the node.
+inline void run_on_node(int node) {
+#if defined(SRT_HAVE_LIBNUMA)
+  if (available()) numa_run_on_node(node);
+#else
+  (void)node;
+#endif
+}
+
+// Spreads the whole pages of [ptr, ptr + bytes) over all nodes. Only affects
+// pages that are not touched yet.
+inline void interleave(void* ptr, std::size_t bytes) {
+#if defined(SRT_HAVE_LIBNUMA)
+  if (!available()) return;
+  const auto page = static_cast<std::uintptr_t>(numa_pagesize());
+  const auto f = (reinterpret_cast<std::uintptr_t>(ptr) + page - 1) / page * page;
+  const auto l = reinterpret_cast<std::uintptr_t>(ptr) + bytes;
+  if (f >= l) return;
+  numa_interleave_memory(reinterpret_cast<void*>(f), l - f, numa_all_nodes_ptr);
+#else
+  (void)ptr;
+  (void)bytes;
+#endif
+}
+
+}  // namespace numa
+
+namespace detail {
+
+// Number of elements from [f1, f1 + n1) among the first k of the merge
+// (the rest, k - result, come from [f2, f2 + n2)). Ties go to the first
+// range, same as in merge_biased.
+template <typename I1, typename I2, typename P>
+DifferenceType<I1> co_rank(DifferenceType<I1> k, I1 f1, DifferenceType<I1> n1,
+                           I2 f2, DifferenceType<I1> n2, P p) {
+  DifferenceType<I1> lo = std::max(DifferenceType<I1>{0}, k - n2);
+  DifferenceType<I1> hi = std::min(k, n1);
+  while (lo < hi) {
+    DifferenceType<I1> mid = lo + (hi - lo) / 2;
+    DifferenceType<I1> j = k - mid;
+    if (j > 0 && !p(f2[j - 1], f1[mid])) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+}  // namespace detail
+
+struct parallel_merge_options {
+  std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+  // Worker i runs on node i * node_count / threads.
+  bool pin_to_nodes = true;
+};
+
+// merge_biased split between threads by output position (co-rank), so that
+// every worker writes one contiguous slice of the output. For the slices to be
+// NUMA local, pass memory that is not touched yet (new T[n] for trivial T):
+// the worker is the first one to write its slice.
+template <typename I1, typename I2, typename O, typename P>
+// requiers RandomAccessIterator<I1> && RandomAccessIterator<I2> &&
+//          RandomAccessIterator<O> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+O parallel_merge_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p,
+                        parallel_merge_options options = {}) {
+  using diff_t = detail::DifferenceType<I1>;
+
+  const diff_t n1 = l1 - f1;
+  const diff_t n2 = static_cast<diff_t>(l2 - f2);
+  const diff_t n = n1 + n2;
+  const diff_t threads = std::max(
+      diff_t{1}, std::min(static_cast<diff_t>(options.threads), n));
+
+  // Splits are computed before any worker starts: with move iterators the
+  // workers change the elements another split would have to look at.
+  std::vector<std::pair<diff_t, diff_t>> splits;
+  splits.reserve(static_cast<std::size_t>(threads) + 1);
+  for (diff_t t = 0; t <= threads; ++t) {
+    const diff_t k = n * t / threads;
+    splits.emplace_back(k, detail::co_rank(k, f1, n1, f2, n2, p));
+  }
+
+  auto worker = [&](diff_t t) {
+    if (options.pin_to_nodes && threads > 1) {
+      numa::run_on_node(static_cast<int>(t * numa::node_count() / threads));
+    }
+    const diff_t k_f = splits[static_cast<std::size_t>(t)].first;
+    const diff_t i_f = splits[static_cast<std::size_t>(t)].second;
+    const diff_t k_l = splits[static_cast<std::size_t>(t) + 1].first;
+    const diff_t i_l = splits[static_cast<std::size_t>(t) + 1].second;
+    merge_biased(f1 + i_f, f1 + i_l, f2 + (k_f - i_f), f2 + (k_l - i_l),
+                 o + k_f, p);
+  };
+
+  if (threads == 1) {
+    worker(0);
+    return o + n;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(static_cast<std::size_t>(threads));
+  for (diff_t t = 0; t != threads; ++t) workers.emplace_back(worker, t);
+  for (std::thread& w : workers) w.join();
+
+  return o + n;
+}
+
+template <typename I1, typename I2, typename O>
+O parallel_merge_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o,
+                        parallel_merge_options options = {}) {
+  return parallel_merge_biased(f1, l1, f2, l2, o, detail::less{}, options);
+}
+
+}  // namespace srt
@@ -1,14 +1,53 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Final algorithms are constexpr when the standard library lets us tell
+// constant evaluation apart: goto is not allowed there, so constant
+// evaluation takes a goto free version with the same comparisons.
+#if defined(__cpp_lib_is_constant_evaluated)
+#define SRT_CONSTEXPR_MERGE constexpr
+#else
+#define SRT_CONSTEXPR_MERGE
+#endif
+
+// Defaults for the merge_biased tuning parameters. A header generated by the
+// merge_tuning target can replace them: -DSRT_MERGE_TUNING_HEADER=\"path\".
+#if defined(SRT_MERGE_TUNING_HEADER)
+#include SRT_MERGE_TUNING_HEADER
+#endif
+
+#if !defined(SRT_MERGE_BIASED_LINEAR_STEPS)
+#define SRT_MERGE_BIASED_LINEAR_STEPS 3
+#endif
+
+#if !defined(SRT_PARTITION_POINT_LINEAR_PROBES)
+#define SRT_PARTITION_POINT_LINEAR_PROBES 3
+#endif
 
 namespace srt {
 
+// Comparisons merge_biased does after taking an element from the second
+// range before it starts galloping.
+constexpr int kMergeBiasedLinearSteps = SRT_MERGE_BIASED_LINEAR_STEPS;
+
+// Elements partition_point_biased_no_checks checks one by one before every
+// round of doubling steps.
+constexpr int kPartitionPointLinearProbes = SRT_PARTITION_POINT_LINEAR_PROBES;
+
 namespace detail {
 
 struct less {
   template <typename T, typename U>
-  bool operator()(const T& x, const U& y) {
+  constexpr bool operator()(const T& x, const U& y) {
     return x < y;
   }
 };
@@ -23,9 +62,11 @@ struct less {
 //       ForwardIterator<I1> && InputIterator<I2> && OutputIterator<O> &&
 //       StrictWeakOrder<P(ValueType<I>, V)>
 
+namespace detail {
+
 template <typename I1, typename I2, typename O, typename P>
 // requiers InputMergeRequirements<I1, I2, O, P>
-O merge_linear(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+O merge_linear_goto(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
   if (f1 == l1) goto copySecond;
   if (f2 == l2) goto copyFirst;
 
@@ -46,8 +87,31 @@ copyFirst:
   return std::copy(f1, l1, o);
 }
 
+template <typename I1, typename I2, typename O, typename P>
+// requiers InputMergeRequirements<I1, I2, O, P>
+constexpr O merge_linear_constexpr(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+  while (f1 != l1 && f2 != l2) {
+    if (p(*f2, *f1)) *o++ = *f2++;
+    else *o++ = *f1++;
+  }
+  return std::copy(f2, l2, std::copy(f1, l1, o));
+}
+
+}  // namespace detail
+
+template <typename I1, typename I2, typename O, typename P>
+// requiers InputMergeRequirements<I1, I2, O, P>
+SRT_CONSTEXPR_MERGE O merge_linear(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+#if defined(__cpp_lib_is_constant_evaluated)
+  if (std::is_constant_evaluated()) {
+    return detail::merge_linear_constexpr(f1, l1, f2, l2, o, p);
+  }
+#endif
+  return detail::merge_linear_goto(f1, l1, f2, l2, o, p);
+}
+
 template <typename I1, typename I2, typename O>
-O merge_linear(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+SRT_CONSTEXPR_MERGE O merge_linear(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
   return merge_linear(f1, l1, f2, l2, o, detail::less{});
 }
 
@@ -56,12 +120,17 @@ namespace detail {
 template <typename I>
 using DifferenceType = typename std::iterator_traits<I>::difference_type;
 
-template <typename I, typename P>
-I partition_point_biased_no_checks(I f, P p) {
+template <int LinearProbes = kPartitionPointLinearProbes, typename I,
+          typename P>
+constexpr I partition_point_biased_no_checks(I f, P p) {
+  // find_boundary only guarantees a failing element in the first half of the
+  // range: with less than 3 probes the first doubling step can jump out of it.
+  static_assert(LinearProbes >= 3, "doubling can go past the end of the range");
   while(true) {
-    if (!p(*f)) return f; ++f;
-    if (!p(*f)) return f;  ++f;
-    if (!p(*f)) return f;  ++f;
+    for (int i = 0; i != LinearProbes; ++i) {
+      if (!p(*f)) return f;
+      ++f;
+    }
     for (DifferenceType<I> step = 2;; step += step) {
       I test = std::next(f, step);
       if (!p(*test)) break;
@@ -71,7 +140,7 @@ I partition_point_biased_no_checks(I f, P p) {
 }
 
 template <typename I>
-I middle(I f, I l) {
+constexpr I middle(I f, I l) {
   static_assert(
     std::numeric_limits<DifferenceType<I>>::max() <=
     std::numeric_limits<size_t>::max(),
@@ -79,18 +148,59 @@ I middle(I f, I l) {
   return std::next(f, static_cast<size_t>(std::distance(f, l)) / 2);
 }
 
-template <typename I, typename P>
-I find_boundary(I f, I l, P p) {
+// Returns an iterator before l, such that everything before it satisfies p,
+// and which either is the partition point or satisfies p itself.
+// requires f != l
+template <int LinearProbes, typename I, typename P>
+constexpr I find_boundary(I f, I l, P p, std::random_access_iterator_tag) {
   I sent = middle(f, l);
   if (p(*sent)) return sent;
-  return partition_point_biased_no_checks(f, p);
+  return partition_point_biased_no_checks<LinearProbes>(f, p);
 }
 
-}  // namespace detail
+// For forward and bidirectional iterators middle() and the doubling steps
+// are walks over the range, on every gallop. Instead the iterators are
+// remembered in a window while walking: the search looks at the last one and
+// then inside the window, every link is followed once.
+constexpr int kForwardGallopWindow = 16;
 
-template <typename I1, typename I2, typename O, typename P>
+template <int LinearProbes, typename I, typename P>
+constexpr I find_boundary(I f, I l, P p, std::forward_iterator_tag) {
+  for (int i = 0; i != LinearProbes; ++i) {
+    if (!p(*f)) return f;
+    I next = std::next(f);
+    if (next == l) return f;
+    f = next;
+  }
+  if (!p(*f)) return f;
+
+  I window[kForwardGallopWindow] = {};
+  while (true) {
+    int n = 0;
+    for (I it = f; n != kForwardGallopWindow; ++n) {
+      if (++it == l) break;
+      window[n] = it;
+    }
+    if (!n) return f;
+    if (!p(*window[n - 1])) {
+      return *std::partition_point(window, window + n - 1,
+                                   [&](const I& x) { return p(*x); });
+    }
+    f = window[n - 1];
+  }
+}
+
+template <int LinearProbes = kPartitionPointLinearProbes, typename I,
+          typename P>
+constexpr I find_boundary(I f, I l, P p) {
+  return find_boundary<LinearProbes>(
+      f, l, p, typename std::iterator_traits<I>::iterator_category{});
+}
+
+template <int LinearSteps, int LinearProbes, typename I1, typename I2,
+          typename O, typename P>
 // requiers ForwardInputMergeRequirements<I1, I2, O, P>
-O merge_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+O merge_biased_goto(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
   if (f1 == l1) goto copySecond;
   if (f2 == l2) goto copyFirst;
 
@@ -101,14 +211,13 @@ while(true) {
   takeSecond:
     *o++ = *f2++;  if (f2 == l2) goto copyFirst;
   nextCheck:
-    if (p(*f2, *f1)) goto takeSecond;
-    *o++ = *f1++; if (f1 == l1) goto copySecond;
-    if (p(*f2, *f1)) goto takeSecond;
-    *o++ = *f1++; if (f1 == l1) goto copySecond;
-    if (p(*f2, *f1)) goto takeSecond;
-    *o++ = *f1++; if (f1 == l1) goto copySecond;
+    for (int i = 0; i != LinearSteps; ++i) {
+      if (p(*f2, *f1)) goto takeSecond;
+      *o++ = *f1++; if (f1 == l1) goto copySecond;
+    }
 
-    I1 next_f1 = detail::find_boundary(f1, l1, [&](const auto& x) { return !p(*f2, x); });
+    I1 next_f1 = find_boundary<LinearProbes>(
+        f1, l1, [&](const auto& x) { return !p(*f2, x); });
     o = std::copy(f1, next_f1, o);
     f1 = next_f1;
   }
@@ -119,9 +228,391 @@ copyFirst:
   return std::copy(f1, l1, o);
 }
 
+// merge_biased_goto for iterators without random access: galloping goes
+// through a window of iterators (see find_boundary) and copies from it, so
+// [f1, l1) is walked once.
+template <int LinearSteps, typename I1, typename I2, typename O, typename P>
+// requiers ForwardInputMergeRequirements<I1, I2, O, P>
+O merge_biased_forward(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+  I1 window[kForwardGallopWindow];
+  I1* boundary = window;
+  int n = 0;
+
+  if (f1 == l1) goto copySecond;
+  if (f2 == l2) goto copyFirst;
+
+while(true) {
+    if (p(*f2, *f1)) goto takeSecond;
+    *o++ = *f1++; if (f1 == l1) goto copySecond;
+    goto nextCheck;
+  takeSecond:
+    *o++ = *f2++;  if (f2 == l2) goto copyFirst;
+  nextCheck:
+    for (int i = 0; i != LinearSteps; ++i) {
+      if (p(*f2, *f1)) goto takeSecond;
+      *o++ = *f1++; if (f1 == l1) goto copySecond;
+    }
+
+    while (true) {
+      for (n = 0; n != kForwardGallopWindow && f1 != l1; ++n, ++f1) {
+        window[n] = f1;
+      }
+      if (p(*f2, *window[n - 1])) break;
+      for (int i = 0; i != n; ++i) *o++ = *window[i];
+      if (f1 == l1) goto copySecond;
+    }
+
+    boundary = std::partition_point(window, window + n - 1, [&](const I1& x) {
+      return !p(*f2, *x);
+    });
+    for (I1* w = window; w != boundary; ++w) *o++ = **w;
+    f1 = *boundary;
+    goto takeSecond;
+  }
+
+copySecond:
+  return std::copy(f2, l2, o);
+copyFirst:
+  return std::copy(f1, l1, o);
+}
+
+template <int LinearSteps, int LinearProbes, typename I1, typename I2,
+          typename O, typename P>
+// requiers ForwardInputMergeRequirements<I1, I2, O, P>
+constexpr O merge_biased_constexpr(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+  if (f1 == l1 || f2 == l2) return std::copy(f2, l2, std::copy(f1, l1, o));
+
+  // Same as the goto version: after taking from the second range there are
+  // LinearSteps comparisons before galloping, after galloping there is one
+  // more.
+  int linear_steps = LinearSteps + 1;
+  while (true) {
+    if (!linear_steps) {
+      I1 next_f1 = find_boundary<LinearProbes>(
+          f1, l1, [&](const auto& x) { return !p(*f2, x); });
+      o = std::copy(f1, next_f1, o);
+      f1 = next_f1;
+      linear_steps = LinearSteps + 1;
+    }
+    if (p(*f2, *f1)) {
+      *o++ = *f2++; if (f2 == l2) return std::copy(f1, l1, o);
+      linear_steps = LinearSteps;
+      continue;
+    }
+    *o++ = *f1++; if (f1 == l1) return std::copy(f2, l2, o);
+    --linear_steps;
+  }
+}
+
+}  // namespace detail
+
+// LinearSteps and LinearProbes are kMergeBiasedLinearSteps and
+// kPartitionPointLinearProbes, unless specified: merge_biased<4, 3>(...).
+//
+// Galloping needs a multipass [f1, l1): for input iterators this is
+// merge_linear. Without random access the gallop doesn't walk back.
+template <int LinearSteps = kMergeBiasedLinearSteps,
+          int LinearProbes = kPartitionPointLinearProbes, typename I1,
+          typename I2, typename O, typename P>
+// requiers InputMergeRequirements<I1, I2, O, P>
+SRT_CONSTEXPR_MERGE O merge_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+  using category = typename std::iterator_traits<I1>::iterator_category;
+  if constexpr (!std::is_base_of<std::forward_iterator_tag, category>::value) {
+    return merge_linear(f1, l1, f2, l2, o, p);
+  } else {
+#if defined(__cpp_lib_is_constant_evaluated)
+    if (std::is_constant_evaluated()) {
+      return detail::merge_biased_constexpr<LinearSteps, LinearProbes>(
+          f1, l1, f2, l2, o, p);
+    }
+#endif
+    if constexpr (!std::is_base_of<std::random_access_iterator_tag,
+                                   category>::value) {
+      return detail::merge_biased_forward<LinearSteps>(f1, l1, f2, l2, o, p);
+    } else {
+      return detail::merge_biased_goto<LinearSteps, LinearProbes>(
+          f1, l1, f2, l2, o, p);
+    }
+  }
+}
+
+template <int LinearSteps = kMergeBiasedLinearSteps,
+          int LinearProbes = kPartitionPointLinearProbes, typename I1,
+          typename I2, typename O>
+SRT_CONSTEXPR_MERGE O merge_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+  return merge_biased<LinearSteps, LinearProbes>(f1, l1, f2, l2, o,
+                                                 detail::less{});
+}
+
+namespace detail {
+
+// Iterators over contiguous memory: pointers and std::vector iterators.
+template <typename I, typename T = typename std::iterator_traits<I>::value_type,
+          typename = void>
+struct is_contiguous_iterator : std::is_pointer<I> {};
+
+template <typename I, typename T>
+struct is_contiguous_iterator<
+    I, T,
+    std::enable_if_t<std::is_object<T>::value && !std::is_same<T, bool>::value>>
+    : std::integral_constant<
+          bool, std::is_pointer<I>::value ||
+                    std::is_same<I, typename std::vector<T>::iterator>::value ||
+                    std::is_same<I, typename std::vector<T>::const_iterator>::
+                        value> {};
+
+// std::copy that is a memcpy for trivially copyable elements in contiguous
+// memory, whatever the standard library does.
+template <typename I, typename O>
+O copy_bulk(I f, I l, O o) {
+  using T = typename std::iterator_traits<I>::value_type;
+  if constexpr (is_contiguous_iterator<I>::value &&
+                is_contiguous_iterator<O>::value &&
+                std::is_same<T, typename std::iterator_traits<
+                                    O>::value_type>::value &&
+                std::is_trivially_copyable<T>::value) {
+    const auto n = l - f;
+    if (n != 0) std::memcpy(&*o, &*f, static_cast<std::size_t>(n) * sizeof(T));
+    return o + n;
+  } else {
+    return std::copy(f, l, o);
+  }
+}
+
+}  // namespace detail
+
+// merge_biased for ranges that mostly don't overlap: appended, prepended or
+// overlapping only near the edges. The endpoints are checked first and the
+// overlap window is found with binary searches, everything outside of it is
+// copied in bulk and only the window is merged.
+//
+// Costs O(log) comparisons more than merge_biased when the ranges are
+// interleaved all the way. Without random access this is merge_biased.
+template <int LinearSteps = kMergeBiasedLinearSteps,
+          int LinearProbes = kPartitionPointLinearProbes, typename I1,
+          typename I2, typename O, typename P>
+// requiers InputMergeRequirements<I1, I2, O, P>
+O merge_biased_adaptive(I1 f1, I1 l1, I2 f2, I2 l2, O o, P p) {
+  using category1 = typename std::iterator_traits<I1>::iterator_category;
+  using category2 = typename std::iterator_traits<I2>::iterator_category;
+  if constexpr (!std::is_base_of<std::random_access_iterator_tag,
+                                 category1>::value ||
+                !std::is_base_of<std::random_access_iterator_tag,
+                                 category2>::value) {
+    return merge_biased<LinearSteps, LinearProbes>(f1, l1, f2, l2, o, p);
+  } else {
+    if (f1 == l1) return detail::copy_bulk(f2, l2, o);
+    if (f2 == l2) return detail::copy_bulk(f1, l1, o);
+
+    // Equal elements from [f1, l1) go first.
+    if (!p(*f2, *(l1 - 1))) {
+      o = detail::copy_bulk(f1, l1, o);
+      return detail::copy_bulk(f2, l2, o);
+    }
+    if (p(*(l2 - 1), *f1)) {
+      o = detail::copy_bulk(f2, l2, o);
+      return detail::copy_bulk(f1, l1, o);
+    }
+
+    // Only one of the ranges has a prefix before the other one and only one
+    // has a suffix after it: two binary searches.
+    I1 window_f1 = f1;
+    I2 window_f2 = f2;
+    if (p(*f2, *f1)) {
+      window_f2 = std::lower_bound(f2, l2, *f1, p);
+    } else {
+      window_f1 = std::upper_bound(f1, l1, *f2, p);
+    }
+
+    I1 window_l1 = l1;
+    I2 window_l2 = l2;
+    if (p(*(l2 - 1), *(l1 - 1))) {
+      window_l1 = std::upper_bound(window_f1, l1, *(l2 - 1), p);
+    } else {
+      window_l2 = std::lower_bound(window_f2, l2, *(l1 - 1), p);
+    }
+
+    o = detail::copy_bulk(f1, window_f1, o);
+    o = detail::copy_bulk(f2, window_f2, o);
+    o = merge_biased<LinearSteps, LinearProbes>(window_f1, window_l1,
+                                                window_f2, window_l2, o, p);
+    o = detail::copy_bulk(window_l1, l1, o);
+    return detail::copy_bulk(window_l2, l2, o);
+  }
+}
+
+template <int LinearSteps = kMergeBiasedLinearSteps,
+          int LinearProbes = kPartitionPointLinearProbes, typename I1,
+          typename I2, typename O>
+O merge_biased_adaptive(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
+  return merge_biased_adaptive<LinearSteps, LinearProbes>(f1, l1, f2, l2, o,
+                                                          detail::less{});
+}
+
+namespace detail {
+
+template <typename C, typename = void>
+struct has_reserve : std::false_type {};
+
+template <typename C>
+struct has_reserve<C, std::void_t<decltype(std::declval<C&>().reserve(
+                          std::declval<typename C::size_type>()))>>
+    : std::true_type {};
+
+// Vectors (with any allocator) of trivial elements: value initialization is
+// a memset, cheaper than a capacity check per element.
+template <typename C>
+struct appends_by_resize
+    : std::integral_constant<
+          bool, has_reserve<C>::value &&
+                    std::is_same<typename std::iterator_traits<
+                                     typename C::iterator>::iterator_category,
+                                 std::random_access_iterator_tag>::value &&
+                    std::is_trivially_default_constructible<
+                        typename C::value_type>::value &&
+                    std::is_trivially_copyable<typename C::value_type>::value> {
+};
+
+}  // namespace detail
+
+// Appends the merge of [f1, l1) and [f2, l2) to c, reusing whatever
+// capacity c already has (a cleared vector or a std::pmr container on a
+// reused memory resource doesn't allocate). Returns the first appended
+// element, like insert.
+//
+// Vectors of trivial elements are resized first, so the appended elements
+// are zeroed before the merge writes them: a memset over the output, which
+// measures faster than a back_inserter that turns every bulk copy into
+// push_backs. Other elements are not value initialized (and don't need a
+// default constructor): the capacity is reserved and the merge goes through
+// a back_inserter.
+template <typename I1, typename I2, typename C, typename P>
+// requiers ForwardIterator<I1> && ForwardIterator<I2> &&
+//          BackInsertionSequence<C> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I2>)>
+typename C::iterator merge_biased_into(I1 f1, I1 l1, I2 f2, I2 l2, C& c,
+                                       P p) {
+  const auto old_size = c.size();
+  const auto new_size =
+      old_size + static_cast<typename C::size_type>(std::distance(f1, l1) +
+                                                    std::distance(f2, l2));
+  if constexpr (detail::appends_by_resize<C>::value) {
+    c.resize(new_size);
+    auto res = std::next(c.begin(), static_cast<std::ptrdiff_t>(old_size));
+    merge_biased(f1, l1, f2, l2, res, p);
+    return res;
+  } else {
+    if constexpr (detail::has_reserve<C>::value) {
+      // Growing by at least twice, like push_back: appending in a loop
+      // stays linear.
+      if (new_size > c.capacity()) {
+        c.reserve(std::max(new_size, 2 * c.capacity()));
+      }
+    }
+    merge_biased(f1, l1, f2, l2, std::back_inserter(c), p);
+    return std::next(c.begin(), static_cast<std::ptrdiff_t>(old_size));
+  }
+}
+
+template <typename I1, typename I2, typename C>
+typename C::iterator merge_biased_into(I1 f1, I1 l1, I2 f2, I2 l2, C& c) {
+  return merge_biased_into(f1, l1, f2, l2, c, detail::less{});
+}
+
+// Moves every element of rhs into lhs, like lhs.merge(rhs), but goes over
+// lhs the way merge_biased does: nodes of rhs are relinked in front of the
+// element they go before, the runs of lhs in between are skipped by
+// galloping. Equal elements from lhs go first.
+// Like std::list::merge, the allocators have to compare equal and merging a
+// list with itself does nothing.
+template <int LinearSteps = kMergeBiasedLinearSteps,
+          int LinearProbes = kPartitionPointLinearProbes, typename T,
+          typename A, typename P>
+// requiers StrictWeakOrder<P(T, T)>
+void merge_biased(std::list<T, A>& lhs, std::list<T, A>& rhs, P p) {
+  if (&lhs == &rhs) return;
+
+  auto f1 = lhs.begin();
+  const auto l1 = lhs.end();
+  if (f1 == l1) goto spliceSecond;
+  if (rhs.empty()) return;
+
+  while (true) {
+    if (p(rhs.front(), *f1)) goto takeSecond;
+    ++f1; if (f1 == l1) goto spliceSecond;
+    goto nextCheck;
+  takeSecond:
+    lhs.splice(f1, rhs, rhs.begin()); if (rhs.empty()) return;
+  nextCheck:
+    for (int i = 0; i != LinearSteps; ++i) {
+      if (p(rhs.front(), *f1)) goto takeSecond;
+      ++f1; if (f1 == l1) goto spliceSecond;
+    }
+
+    f1 = detail::find_boundary<LinearProbes>(
+        f1, l1, [&](const T& x) { return !p(rhs.front(), x); });
+  }
+
+spliceSecond:
+  lhs.splice(l1, rhs);
+}
+
+template <int LinearSteps = kMergeBiasedLinearSteps,
+          int LinearProbes = kPartitionPointLinearProbes, typename T,
+          typename A>
+void merge_biased(std::list<T, A>& lhs, std::list<T, A>& rhs) {
+  merge_biased<LinearSteps, LinearProbes>(lhs, rhs, detail::less{});
+}
+
+// Merges every sorted range in [batches_f, batches_l) into [f1, l1) with a
+// single pass over [f1, l1). Batches are merged with each other first
+// (pairwise, merge_linear) and then the result goes through one merge_biased.
+// On equal elements [f1, l1) goes first, then the batches in their order.
+template <typename I1, typename I2, typename O, typename P>
+// requiers ForwardIterator<I1> && InputIterator<I2> &&
+//          ForwardRange<ValueType<I2>> && OutputIterator<O> &&
+//          StrictWeakOrder<P(ValueType<I1>, ValueType<I1>)>
+O merge_biased_batched(I1 f1, I1 l1, I2 batches_f, I2 batches_l, O o, P p) {
+  using T = typename std::iterator_traits<I1>::value_type;
+
+  std::vector<T> small;
+  std::vector<std::size_t> bounds{0};
+  for (; batches_f != batches_l; ++batches_f) {
+    small.insert(small.end(), std::begin(*batches_f), std::end(*batches_f));
+    bounds.push_back(small.size());
+  }
+
+  // Every level is appended to buf: no default constructed elements.
+  std::vector<T> buf;
+  while (bounds.size() > 2) {
+    buf.clear();
+    buf.reserve(small.size());
+    std::vector<std::size_t> next_bounds{0};
+    std::size_t i = 0;
+    for (; i + 2 < bounds.size(); i += 2) {
+      merge_linear(std::make_move_iterator(small.begin() + bounds[i]),
+                   std::make_move_iterator(small.begin() + bounds[i + 1]),
+                   std::make_move_iterator(small.begin() + bounds[i + 1]),
+                   std::make_move_iterator(small.begin() + bounds[i + 2]),
+                   std::back_inserter(buf), p);
+      next_bounds.push_back(bounds[i + 2]);
+    }
+    if (i + 1 < bounds.size()) {
+      std::move(small.begin() + bounds[i], small.begin() + bounds[i + 1],
+                std::back_inserter(buf));
+      next_bounds.push_back(bounds[i + 1]);
+    }
+    small.swap(buf);
+    bounds.swap(next_bounds);
+  }
+
+  return merge_biased(f1, l1, std::make_move_iterator(small.begin()),
+                      std::make_move_iterator(small.end()), o, p);
+}
+
 template <typename I1, typename I2, typename O>
-O merge_biased(I1 f1, I1 l1, I2 f2, I2 l2, O o) {
-  return merge_biased(f1, l1, f2, l2, o, detail::less{});
+O merge_biased_batched(I1 f1, I1 l1, I2 batches_f, I2 batches_l, O o) {
+  return merge_biased_batched(f1, l1, batches_f, batches_l, o, detail::less{});
 }
 
 }  // namespace srt
\ No newline at end of file
@@ -0,0 +1,164 @@
+import argparse
+import collections
+import json
+import os
+import random
+import re
+import statistics
+import subprocess
+import sys
+
+# Runs every merge algorithm of the benchmarks target in its own process, a
+# few times, each repetition built with a random code alignment
+# (-falign-functions / -falign-loops, see BENCHMARK_ALIGN_* in CMakeLists.txt).
+#
+# The spread of one measurement over the repetitions is how much the code
+# layout alone moves it: a win smaller than that isn't a win.
+#
+#   python3 run_isolated.py --source . --build-root ../isolated \
+#       --algorithms merge_biased,merge_linear -- --merge_max_rhs_size=40
+#
+# Writes <out>/<algorithm>.json with all the repetitions (compare_results.py
+# takes two such directories) and prints the spread per algorithm.
+# Arguments after "--" go to every benchmarks run.
+
+alignFunctions = [16, 32, 64, 128, 256, 512, 1024, 2048, 4096]
+alignLoops = [1, 8, 16, 32, 64]
+
+def run(command):
+    print(' '.join(command), file=sys.stderr)
+    subprocess.run(command, check=True)
+
+def buildBenchmarks(options, functions, loops):
+    buildDir = os.path.join(options.buildRoot,
+                            'align_{}_{}'.format(functions, loops))
+    run(['cmake', '-S', options.source, '-B', buildDir,
+         '-DCMAKE_BUILD_TYPE=Release',
+         '-DBENCHMARK_ALIGN_FUNCTIONS={}'.format(functions),
+         '-DBENCHMARK_ALIGN_LOOPS={}'.format(loops)] + options.cmakeArgs)
+    run(['cmake', '--build', buildDir, '--target', 'benchmarks'])
+    return os.path.join(buildDir, 'benchmarks')
+
+def listAlgorithms(binary):
+    names = subprocess.run([binary, '--benchmark_list_tests'], check=True,
+                           stdout=subprocess.PIPE, universal_newlines=True).stdout
+    res = []
+    for match in re.finditer(r'^benchmark_merge<(\w+)>', names, re.MULTILINE):
+        if match.group(1) not in res:
+            res.append(match.group(1))
+    return res
+
+class spread:
+    def __init__(self, name, times):
+        self.name = name
+        self.median = statistics.median(times)
+        self.relative = (max(times) - min(times)) / self.median
+
+class runner:
+    def __init__(self):
+        self.options = None
+        self.binaries = []
+        self.algorithms = []
+        self.rng = None
+        self.results = collections.OrderedDict()
+
+    def parseFromOptions(self):
+        parser = argparse.ArgumentParser(\
+        description='Runs merge algorithms in separate processes with random code alignment')
+        parser.add_argument('--source', dest='source', default='.',
+                            help='directory with CMakeLists.txt')
+        parser.add_argument('--build-root', dest='buildRoot', default='isolated_builds',
+                            help='where the builds with different alignments go')
+        parser.add_argument('--binary', dest='binary', default=None,
+                            help='use this benchmarks binary for every repetition, '
+                                 'only isolates processes (no rebuilds)')
+        parser.add_argument('--cmake-arg', dest='cmakeArgs', action='append', default=[],
+                            help='extra cmake argument, can be repeated')
+        parser.add_argument('--algorithms', dest='algorithms', default='',
+                            help='comma separated, all merge algorithms by default')
+        parser.add_argument('--repetitions', type=int, dest='repetitions', default=5)
+        parser.add_argument('--seed', type=int, dest='seed', default=None)
+        parser.add_argument('--out', dest='out', default='isolated_results',
+                            help='directory for the json results')
+        parser.add_argument('benchmarkArgs', nargs='*',
+                            help='arguments for the benchmarks binary (after --)')
+        self.options = parser.parse_args()
+        if self.options.repetitions < 2:
+            parser.error('need at least 2 repetitions to see a spread')
+        self.rng = random.Random(self.options.seed)
+
+    def build(self):
+        for _ in range(self.options.repetitions):
+            if self.options.binary:
+                self.binaries.append(self.options.binary)
+                continue
+            functions = self.rng.choice(alignFunctions)
+            loops = self.rng.choice(alignLoops)
+            self.binaries.append(buildBenchmarks(self.options, functions, loops))
+
+        if self.options.algorithms:
+            self.algorithms = self.options.algorithms.split(',')
+        else:
+            self.algorithms = listAlgorithms(self.binaries[0])
+
+    def runAll(self):
+        os.makedirs(self.options.out, exist_ok=True)
+        userFilter = any(a.startswith('--benchmark_filter') for a in self.options.benchmarkArgs)
+        for repetition, binary in enumerate(self.binaries):
+            # A different order every time: no algorithm always runs on a
+            # cold or a throttled machine.
+            algorithms = list(self.algorithms)
+            self.rng.shuffle(algorithms)
+            for algorithm in algorithms:
+                outPath = os.path.join(self.options.out,
+                                       '{}.{}.json'.format(algorithm, repetition))
+                command = [binary, '--merge_algorithms=' + algorithm,
+                           '--benchmark_out=' + outPath,
+                           '--benchmark_out_format=json']
+                if not userFilter:
+                    command.append('--benchmark_filter=^benchmark_merge<' + algorithm + '>')
+                run(command + self.options.benchmarkArgs)
+                self.collect(algorithm, repetition, outPath)
+                os.remove(outPath)
+
+    def collect(self, algorithm, repetition, path):
+        loaded = json.load(open(path))
+        merged = self.results.setdefault(algorithm, {'context': loaded['context'],
+                                                     'benchmarks': []})
+        merged['context'].setdefault('isolated_alignments', [])
+        merged['context']['isolated_alignments'].append(
+            '{}/{}'.format(loaded['context'].get('align_functions', 'default'),
+                           loaded['context'].get('align_loops', 'default')))
+        for measurement in loaded['benchmarks']:
+            if measurement.get('run_type', 'iteration') != 'iteration':
+                continue
+            measurement['run_name'] = measurement.get('run_name', measurement['name'])
+            measurement['run_type'] = 'iteration'
+            measurement['repetition_index'] = repetition
+            merged['benchmarks'].append(measurement)
+
+    def report(self):
+        for algorithm, merged in self.results.items():
+            with open(os.path.join(self.options.out, algorithm + '.json'), 'w') as out:
+                json.dump(merged, out, indent=2)
+
+            times = collections.OrderedDict()
+            for measurement in merged['benchmarks']:
+                if measurement.get('error_occurred', False):
+                    continue
+                times.setdefault(measurement['run_name'], []).append(
+                    float(measurement['real_time']))
+            spreads = [spread(name, ts) for name, ts in times.items() if len(ts) > 1]
+            if not spreads:
+                continue
+            worst = max(spreads, key = lambda s: s.relative)
+            print('{:<30} median spread {:>6.1%}, max {:>6.1%} ({})'.format(
+                algorithm, statistics.median(s.relative for s in spreads),
+                worst.relative, worst.name))
+
+if __name__ == "__main__":
+    r = runner()
+    r.parseFromOptions()
+    r.build()
+    r.runAll()
+    r.report()